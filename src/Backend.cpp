@@ -20,10 +20,17 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <QApplication>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QThread>
 
 #include <stdint.h>
 
+#include <list>
+#include <map>
+#include <set>
+#include <utility>
+
 #include "Backend.h"
 #include "Logger.h"
 #include "Object.h"
@@ -68,6 +75,142 @@ static std::string toolkitObjectProperty (const graphics_object& go)
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Pending changes of a figure while an update transaction is open, see
+// Backend::beginTransaction.
+
+struct Transaction
+{
+  Transaction (void) : m_depth (0), m_redraw (false) { }
+
+  int m_depth;
+  std::list<std::pair<double, int> > m_updates;
+  std::set<std::pair<double, int> > m_pending;
+  bool m_redraw;
+};
+
+// Protected by the gh_manager lock, indexed by figure handle.
+static std::map<double, Transaction> s_transactions;
+
+//////////////////////////////////////////////////////////////////////////////
+
+static Transaction* figureTransaction (const graphics_object& go)
+{
+  if (! s_transactions.empty ())
+    {
+      graphics_object fig = go.get_ancestor ("figure");
+
+      if (fig.valid_object ())
+	{
+	  std::map<double, Transaction>::iterator it =
+	    s_transactions.find (fig.get_handle ().value ());
+
+	  if (it != s_transactions.end ())
+	    return &(it->second);
+	}
+    }
+
+  return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Number of uicontrol (or uipanel) and uimenu direct children of each
+// figure, indexed by figure handle, and the figure each counted child is
+// attached to, indexed by child handle.
+
+struct ChildCounts
+{
+  ChildCounts (void) : m_uiControls (0), m_uiMenus (0) { }
+
+  int m_uiControls;
+  int m_uiMenus;
+};
+
+struct ChildRecord
+{
+  double m_figure;
+  bool m_uiMenu;
+};
+
+static QMutex s_childCountMutex;
+static std::map<double, ChildCounts> s_childCounts;
+static std::map<double, ChildRecord> s_childRecords;
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void unregisterChild (const graphics_object& go)
+{
+  QMutexLocker lock (&s_childCountMutex);
+
+  std::map<double, ChildRecord>::iterator it =
+    s_childRecords.find (go.get_handle ().value ());
+
+  if (it != s_childRecords.end ())
+    {
+      ChildCounts& counts = s_childCounts[it->second.m_figure];
+
+      if (it->second.m_uiMenu)
+	counts.m_uiMenus--;
+      else
+	counts.m_uiControls--;
+
+      s_childRecords.erase (it);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void registerChild (const graphics_object& go)
+{
+  unregisterChild (go);
+
+  bool uiMenu = go.isa ("uimenu");
+
+  if (uiMenu || go.isa ("uicontrol") || go.isa ("uipanel")
+      || go.isa ("uibuttongroup"))
+    {
+      graphics_object parent = gh_manager::get_object (go.get_parent ());
+
+      if (parent.valid_object () && parent.isa ("figure"))
+	{
+	  QMutexLocker lock (&s_childCountMutex);
+
+	  ChildRecord r;
+
+	  r.m_figure = parent.get_handle ().value ();
+	  r.m_uiMenu = uiMenu;
+
+	  s_childRecords[go.get_handle ().value ()] = r;
+
+	  ChildCounts& counts = s_childCounts[r.m_figure];
+
+	  if (uiMenu)
+	    counts.m_uiMenus++;
+	  else
+	    counts.m_uiControls++;
+	}
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static bool isAncestorBeingDeleted (const graphics_object& go)
+{
+  graphics_object parent = gh_manager::get_object (go.get_parent ());
+
+  while (parent.valid_object ())
+    {
+      if (parent.get_properties ().is_beingdeleted ())
+	return true;
+
+      parent = gh_manager::get_object (parent.get_parent ());
+    }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 Backend::Backend (void)
   : QObject (), base_graphics_toolkit ("qt")
 {
@@ -99,6 +242,8 @@ bool Backend::initialize (const graphics_object& go)
       Logger::debug ("Backend::initialize %s from thread %08x",
 		     go.type ().c_str (), QThread::currentThreadId ());
 
+      registerChild (go);
+
       ObjectProxy* proxy = new ObjectProxy ();
       graphics_object gObj (go);
 
@@ -132,10 +277,21 @@ void Backend::update (const graphics_object& go, int pId)
   Logger::debug ("Backend::update %s(%d) from thread %08x",
 		 go.type ().c_str (), pId, QThread::currentThreadId ());
 
+  if (pId == base_properties::ID_PARENT)
+    registerChild (go);
+
   ObjectProxy* proxy = toolkitObjectProxy (go);
 
   if (proxy)
     {
+      // Don't bother updating objects whose ancestor is going away, they
+      // will be destroyed along with it.
+      if (isAncestorBeingDeleted (go))
+	return;
+
+      if (deferUpdate (go, pId))
+	return;
+
       if (go.isa ("uicontrol")
 	  && pId == uicontrol::properties::ID_STYLE)
 	{
@@ -145,8 +301,26 @@ void Backend::update (const graphics_object& go, int pId)
 	  finalize (go);
 	  initialize (go);
 	}
+      else if (pId == base_properties::ID_VISIBLE
+	       && go.get_properties ().is_visible ()
+	       && ! proxy->object ())
+	{
+	  // Hidden objects are not created until they become visible, see
+	  // ObjectFactory::createObject.
+
+	  emit createObject (go.get_handle ().value ());
+	}
       else
-	proxy->update (pId);
+	{
+	  proxy->update (pId);
+
+	  // Children added while the object was hidden were deferred, the
+	  // factory creates them now that it is shown again.
+	  if (pId == base_properties::ID_VISIBLE
+	      && go.get_properties ().is_visible ()
+	      && (go.isa ("figure") || go.isa ("uipanel")))
+	    emit createObject (go.get_handle ().value ());
+	}
     }
 }
 
@@ -161,20 +335,41 @@ void Backend::finalize (const graphics_object& go)
 
   if (proxy)
     {
-      proxy->finalize ();
+      // When an ancestor is being deleted, the whole subtree is going away:
+      // simply detach the toolkit object, its widget will be destroyed in
+      // one operation when the ancestor itself is finalized.
+      if (isAncestorBeingDeleted (go))
+	proxy->release ();
+      else
+	proxy->finalize ();
       delete proxy;
 
       graphics_object gObj (go);
 
       gObj.get_properties ().set (toolkitObjectProperty (go), Matrix ());
     }
+
+  unregisterChild (go);
+
+  if (go.isa ("figure"))
+    {
+      s_transactions.erase (go.get_handle ().value ());
+
+      QMutexLocker lock (&s_childCountMutex);
+
+      s_childCounts.erase (go.get_handle ().value ());
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void Backend::redraw_figure (const graphics_object& go) const
 {
-  if (go.get_properties ().is_visible ())
+  Transaction* t = figureTransaction (go);
+
+  if (t)
+    t->m_redraw = true;
+  else if (go.get_properties ().is_visible ())
     {
       ObjectProxy* proxy = toolkitObjectProxy (go);
 
@@ -217,4 +412,89 @@ ObjectProxy* Backend::toolkitObjectProxy (const graphics_object& go)
 
 //////////////////////////////////////////////////////////////////////////////
 
+int Backend::uiControlChildCount (const graphics_handle& fig)
+{
+  QMutexLocker lock (&s_childCountMutex);
+
+  std::map<double, ChildCounts>::const_iterator it =
+    s_childCounts.find (fig.value ());
+
+  return (it != s_childCounts.end () ? it->second.m_uiControls : 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+int Backend::uiMenuChildCount (const graphics_handle& fig)
+{
+  QMutexLocker lock (&s_childCountMutex);
+
+  std::map<double, ChildCounts>::const_iterator it =
+    s_childCounts.find (fig.value ());
+
+  return (it != s_childCounts.end () ? it->second.m_uiMenus : 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool Backend::deferUpdate (const graphics_object& go, int pId)
+{
+  Transaction* t = figureTransaction (go);
+
+  if (t)
+    {
+      std::pair<double, int> u (go.get_handle ().value (), pId);
+
+      // Only the first change of a property is recorded, the toolkit
+      // object reads the current value when the update is applied.
+      if (t->m_pending.insert (u).second)
+	t->m_updates.push_back (u);
+
+      return true;
+    }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Backend::beginTransaction (const graphics_object& fig)
+{
+  s_transactions[fig.get_handle ().value ()].m_depth++;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Backend::endTransaction (const graphics_object& fig, bool force)
+{
+  std::map<double, Transaction>::iterator it =
+    s_transactions.find (fig.get_handle ().value ());
+
+  if (it != s_transactions.end ()
+      && (force || --(it->second.m_depth) <= 0))
+    {
+      Transaction t = it->second;
+
+      s_transactions.erase (it);
+
+      Logger::debug ("Backend::endTransaction: applying %d updates",
+		     static_cast<int> (t.m_updates.size ()));
+
+      graphics_toolkit tk = fig.get_toolkit ();
+
+      for (std::list<std::pair<double, int> >::const_iterator
+	   u = t.m_updates.begin (); u != t.m_updates.end (); ++u)
+	{
+	  graphics_object go = gh_manager::get_object (u->first);
+
+	  if (go.valid_object ())
+	    tk.update (go, u->second);
+	}
+
+      if (t.m_redraw || ! t.m_updates.empty ())
+	tk.redraw_figure (fig);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 };
@@ -63,6 +63,20 @@ public:
 
   static ObjectProxy* toolkitObjectProxy (const graphics_object& go);
 
+  // Number of uicontrol/uipanel and uimenu direct children of a figure
+  static int uiControlChildCount (const graphics_handle& fig);
+  static int uiMenuChildCount (const graphics_handle& fig);
+
+  static void beginTransaction (const graphics_object& fig);
+
+  // Closes one level of nesting, or all of them if force is true (to
+  // recover from a script that failed before closing its transactions).
+  static void endTransaction (const graphics_object& fig,
+			      bool force = false);
+
+private:
+  static bool deferUpdate (const graphics_object& go, int pId);
+
 signals:
   void createObject (double handle);
 };
@@ -25,7 +25,9 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #include <QWidget>
 
 #include "BaseControl.h"
+#include "Container.h"
 #include "ContextMenu.h"
+#include "EventWakeup.h"
 #include "Utils.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -69,6 +71,16 @@ static void updatePalette (const uicontrol::properties& props, QWidget* w)
 
 //////////////////////////////////////////////////////////////////////////////
 
+static void updateLayout (const uicontrol::properties& props, QWidget* w)
+{
+  Container* container = dynamic_cast<Container*> (w->parentWidget ());
+
+  if (container)
+    container->setChildLayout (w, props);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 BaseControl::BaseControl (const graphics_object& go, QWidget* w)
   : Object (go, w), m_normalizedFont (false), m_keyPressHandlerDefined (false)
 {
@@ -87,6 +99,7 @@ void BaseControl::init (QWidget* w, bool callBase)
   Matrix bb = up.get_boundingbox (false);
   w->setGeometry (xround (bb(0)), xround (bb(1)),
 		  xround (bb(2)), xround (bb(3)));
+  updateLayout (up, w);
   w->setFont (Utils::computeFont<uicontrol> (up, bb(3)));
   updatePalette (up, w);
   w->setEnabled (up.enable_is ("on"));
@@ -119,8 +132,12 @@ void BaseControl::update (int pId)
 	  Matrix bb = up.get_boundingbox (false);
 	  w->setGeometry (xround (bb(0)), xround (bb(1)),
 			  xround (bb(2)), xround (bb(3)));
+	  updateLayout (up, w);
 	}
       break;
+    case uicontrol::properties::ID_UNITS:
+      updateLayout (up, w);
+      break;
     case uicontrol::properties::ID_FONTNAME:
     case uicontrol::properties::ID_FONTSIZE:
     case uicontrol::properties::ID_FONTWEIGHT:
@@ -181,14 +198,14 @@ bool BaseControl::eventFilter (QObject* watched, QEvent* event)
 	  if (m->button () != Qt::LeftButton
 	      || ! up.enable_is ("on"))
 	    {
-	      gh_manager::post_set (fig.get_handle (), "selectiontype",
+	      EventWakeup::postSet (fig.get_handle (), "selectiontype",
 				    Utils::figureSelectionType (m), false);
-	      gh_manager::post_set (fig.get_handle (), "currentpoint",
+	      EventWakeup::postSet (fig.get_handle (), "currentpoint",
 				    Utils::figureCurrentPoint (fig, m),
 				    false);
-	      gh_manager::post_callback (fig.get_handle (),
-					 "windowbuttondownfcn");
-	      gh_manager::post_callback (m_handle, "buttondownfcn");
+	      EventWakeup::postCallback (fig.get_handle (),
+					  "windowbuttondownfcn");
+	      EventWakeup::postCallback (m_handle, "buttondownfcn");
 
 	      if (m->button () == Qt::RightButton)
 		ContextMenu::executeAt (up, m->globalPos ());
@@ -196,10 +213,10 @@ bool BaseControl::eventFilter (QObject* watched, QEvent* event)
 	  else
 	    {
 	      if (up.style_is ("listbox"))
-		gh_manager::post_set (fig.get_handle (), "selectiontype",
+		EventWakeup::postSet (fig.get_handle (), "selectiontype",
 				      Utils::figureSelectionType (m), false);
 	      else
-		gh_manager::post_set (fig.get_handle (), "selectiontype",
+		EventWakeup::postSet (fig.get_handle (), "selectiontype",
 				      octave_value ("normal"), false);
 	    }
 	}
@@ -213,9 +230,9 @@ bool BaseControl::eventFilter (QObject* watched, QEvent* event)
             Utils::makeKeyEventStruct (dynamic_cast<QKeyEvent*> (event));
           graphics_object fig = object ().get_ancestor ("figure");
 
-          gh_manager::post_set (fig.get_handle (), "currentcharacter",
+          EventWakeup::postSet (fig.get_handle (), "currentcharacter",
                                 keyData.getfield ("Character"), false);
-          gh_manager::post_callback (m_handle, "keypressfcn", keyData);
+          EventWakeup::postCallback (m_handle, "keypressfcn", keyData);
         }
       break;
     default: break;
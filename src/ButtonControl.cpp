@@ -23,6 +23,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "ButtonControl.h"
 #include "Container.h"
+#include "EventWakeup.h"
 #include "Utils.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -111,8 +112,8 @@ void ButtonControl::toggled (bool checked)
 
       if (oldValue.numel() != 1
 	  || (newValue != oldValue(0)))
-	gh_manager::post_set (m_handle, "value", newValue, false);
-      gh_manager::post_callback (m_handle, "callback");
+	EventWakeup::postSet (m_handle, "value", newValue, false);
+      EventWakeup::postCallback (m_handle, "callback");
     }
 }
 
@@ -123,7 +124,7 @@ void ButtonControl::clicked (void)
   QAbstractButton* btn = qWidget<QAbstractButton> ();
 
   if (! btn->isCheckable ())
-    gh_manager::post_callback (m_handle, "callback");
+    EventWakeup::postCallback (m_handle, "callback");
 }
 
 //////////////////////////////////////////////////////////////////////////////
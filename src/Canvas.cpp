@@ -27,6 +27,8 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #include "Backend.h"
 #include "Canvas.h"
 #include "ContextMenu.h"
+#include "EventCoalescer.h"
+#include "EventWakeup.h"
 #include "GLCanvas.h"
 #include "Utils.h"
 
@@ -39,6 +41,9 @@ namespace QtHandles
 
 void Canvas::redraw (bool sync)
 {
+  if (! m_redrawBlocked && ! m_resizing && requestFrame ())
+    return;
+
   if (sync)
     qWidget ()->repaint ();
   else
@@ -54,13 +59,42 @@ void Canvas::blockRedraw (bool block)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Canvas::setResizing (bool resizing)
+{
+  // While the window is being resized interactively, the figure is not
+  // rendered again: the last frame is simply scaled to the canvas.
+
+  if (resizing && ! m_resizing)
+    m_resizing = grabFrame ();
+  else if (! resizing)
+    m_resizing = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Canvas::setEventMask (int m)
+{
+  m_eventMask = m;
+
+  // Motion events without any button pressed are only needed when
+  // "windowbuttonmotionfcn" is defined.
+  qWidget ()->setMouseTracking (m_eventMask & ButtonMotion);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Canvas::canvasPaintEvent (void)
 {
-  if (! m_redrawBlocked)
+  if (m_resizing)
+    drawGrabbedFrame ();
+  else if (! m_redrawBlocked)
     {
-      gh_manager::auto_lock lock;
+      if (! drawFrame ())
+	{
+	  gh_manager::auto_lock lock;
 
-      draw (m_handle);
+	  draw (m_handle);
+	}
 
       if (m_mouseMode == ZoomMode && m_mouseAxes.ok ())
 	drawZoomBox (m_mouseAnchor, m_mouseCurrent);
@@ -139,6 +173,21 @@ void Canvas::canvasMouseMoveEvent (QMouseEvent* event)
 	  break;
 	}
     }
+  else if (m_mouseMode == NoMode && (m_eventMask & ButtonMotion))
+    {
+      graphics_object obj = gh_manager::get_object (m_handle);
+
+      if (obj.valid_object ())
+	{
+	  graphics_object figObj (obj.get_ancestor ("figure"));
+
+	  // Motion events are merged until octave has consumed the
+	  // previous one, slow callbacks don't build up a backlog.
+	  EventCoalescer::post (figObj.get_handle (), "currentpoint",
+				Utils::figureCurrentPoint (figObj, event),
+				"windowbuttonmotionfcn");
+	}
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -233,15 +282,16 @@ void Canvas::canvasMousePressEvent (QMouseEvent* event)
       switch (newMouseMode)
 	{
 	case NoMode:
-	  gh_manager::post_set (figObj.get_handle (), "selectiontype",
+	  EventCoalescer::discard (figObj.get_handle (), "currentpoint");
+	  EventWakeup::postSet (figObj.get_handle (), "selectiontype",
 				Utils::figureSelectionType (event), false);
-	  gh_manager::post_set (figObj.get_handle (), "currentpoint",
+	  EventWakeup::postSet (figObj.get_handle (), "currentpoint",
 				Utils::figureCurrentPoint (figObj, event),
 				false);
-	  gh_manager::post_callback (figObj.get_handle (),
-				     "windowbuttondownfcn");
-          gh_manager::post_callback (currentObj.get_handle (),
-                                     "buttondownfcn");
+	  EventWakeup::postCallback (figObj.get_handle (),
+				      "windowbuttondownfcn");
+          EventWakeup::postCallback (currentObj.get_handle (),
+                                      "buttondownfcn");
 	  if (event->button () == Qt::RightButton)
 	    ContextMenu::executeAt (currentObj.get_properties (),
 				    event->globalPos ());
@@ -330,11 +380,12 @@ void Canvas::canvasMouseReleaseEvent (QMouseEvent* event)
         {
           graphics_object figObj (obj.get_ancestor ("figure"));
 
-	  gh_manager::post_set (figObj.get_handle (), "currentpoint",
+	  EventCoalescer::discard (figObj.get_handle (), "currentpoint");
+	  EventWakeup::postSet (figObj.get_handle (), "currentpoint",
 				Utils::figureCurrentPoint (figObj, event),
 				false);
-          gh_manager::post_callback (figObj.get_handle (),
-                                     "windowbuttonupfcn");
+          EventWakeup::postCallback (figObj.get_handle (),
+                                      "windowbuttonupfcn");
         }
     }
 
@@ -350,9 +401,9 @@ bool Canvas::canvasKeyPressEvent (QKeyEvent* event)
     {
       octave_scalar_map eventData = Utils::makeKeyEventStruct (event);
 
-      gh_manager::post_set (m_handle, "currentcharacter",
+      EventWakeup::postSet (m_handle, "currentcharacter",
                             eventData.getfield ("Character"), false);
-      gh_manager::post_callback (m_handle, "keypressfcn", eventData);
+      EventWakeup::postCallback (m_handle, "keypressfcn", eventData);
 
       return true;
     }
@@ -366,8 +417,8 @@ bool Canvas::canvasKeyReleaseEvent (QKeyEvent* event)
 {
   if (! event->isAutoRepeat () && (m_eventMask & KeyRelease))
     {
-      gh_manager::post_callback (m_handle, "keyreleasefcn",
-                                 Utils::makeKeyEventStruct (event));
+      EventWakeup::postCallback (m_handle, "keyreleasefcn",
+                                  Utils::makeKeyEventStruct (event));
 
       return true;
     }
@@ -45,8 +45,9 @@ class Canvas
 public:
   enum EventMask
     {
-      KeyPress   = 0x01,
-      KeyRelease = 0x02
+      KeyPress     = 0x01,
+      KeyRelease   = 0x02,
+      ButtonMotion = 0x04
     };
 
 public:
@@ -54,10 +55,15 @@ public:
 
   void redraw (bool sync = false);
   void blockRedraw (bool block = true);
+  void setResizing (bool resizing);
+  bool isResizing (void) const { return m_resizing; }
 
-  void addEventMask (int m) { m_eventMask |= m; }
-  void clearEventMask (int m) { m_eventMask &= (~m); }
-  void setEventMask (int m) { m_eventMask = m; }
+  void addEventMask (int m) { setEventMask (m_eventMask | m); }
+  void clearEventMask (int m) { setEventMask (m_eventMask & (~m)); }
+  void setEventMask (int m);
+
+  graphics_handle handle (void) const { return m_handle; }
+  void setHandle (const graphics_handle& handle) { m_handle = handle; }
 
   virtual QWidget* qWidget (void) = 0;
 
@@ -71,10 +77,24 @@ protected:
   virtual graphics_object selectFromAxes (const graphics_object& ax,
                                           const QPoint& pt) = 0;
 
+  // Keep a copy of the last rendered frame (returns false if there is
+  // none yet) and draw it fitted to the current canvas size, see
+  // setResizing.
+  virtual bool grabFrame (void) = 0;
+  virtual void drawGrabbedFrame (void) = 0;
+
+  // Canvases rendering in another thread return true: requestFrame starts
+  // rendering a new frame (the canvas repaints itself once it's ready),
+  // and drawFrame shows the last finished one, without the gh_manager
+  // lock.
+  virtual bool requestFrame (void) { return false; }
+  virtual bool drawFrame (void) { return false; }
+
 protected:
   Canvas (const graphics_handle& handle)
     : m_handle (handle),
       m_redrawBlocked (false),
+      m_resizing (false),
       m_mouseMode (NoMode),
       m_eventMask (0)
     { }
@@ -89,6 +109,7 @@ protected:
 private:
   graphics_handle m_handle;
   bool m_redrawBlocked;
+  bool m_resizing;
   MouseMode m_mouseMode;
   QPoint m_mouseAnchor;
   QPoint m_mouseCurrent;
@@ -19,6 +19,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 */
 
+#include <QChildEvent>
 #include <QVBoxLayout>
 
 #include <octave/oct.h>
@@ -60,44 +61,109 @@ Canvas* Container::canvas (const graphics_handle& handle, bool create)
 	{
 	  graphics_object fig = go.get_ancestor ("figure");
 
-	  m_canvas = Canvas::create (fig.get("renderer").string_value (),
-				     this, handle);
-
-	  QWidget* canvasWidget = m_canvas->qWidget ();
-
-	  canvasWidget->lower ();
-	  canvasWidget->show ();
-	  canvasWidget->setGeometry (0, 0, width (), height ());
+	  setCanvas (Canvas::create (fig.get("renderer").string_value (),
+				     this, handle));
 	}
     }
+  else if (m_canvas && ! m_canvas->handle ().ok () && handle.ok ())
+    {
+      // Pre-built canvas, see FigureWindowPool
+      m_canvas->setHandle (handle);
+    }
 
   return m_canvas;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Container::setCanvas (Canvas* canvas)
+{
+  m_canvas = canvas;
+
+  QWidget* canvasWidget = m_canvas->qWidget ();
+
+  canvasWidget->lower ();
+  canvasWidget->show ();
+  canvasWidget->setGeometry (0, 0, width (), height ());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Container::setChildLayout (QWidget* w, const base_properties& props)
+{
+  // Must be called with the gh_manager lock held, whenever the position
+  // or the units of the child object change. The layout is used by
+  // resizeEvent to compute the child geometry without going back to
+  // the object properties.
+
+  ChildLayout l;
+
+  if (props.get ("units").string_value () == "normalized")
+    {
+      Matrix pos = props.get ("position").matrix_value ();
+
+      l.m_rect = QRectF (pos(0), pos(1), pos(2), pos(3));
+      l.m_normalized = true;
+    }
+  else
+    {
+      // Other units don't depend on the container size.
+      graphics_object parent = gh_manager::get_object (props.get_parent ());
+      Matrix pbb = parent.get_properties ().get_boundingbox (true);
+      Matrix bb = props.get_boundingbox (false);
+
+      l.m_rect = QRectF (bb(0), pbb(3) - bb(1) - bb(3), bb(2), bb(3));
+      l.m_normalized = false;
+    }
+
+  m_childLayouts[w] = l;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Container::childEvent (QChildEvent* event)
+{
+  if (event->removed ())
+    m_childLayouts.remove (event->child ());
+
+  ContainerBase::childEvent (event);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Container::resizeEvent (QResizeEvent* /* event */)
 {
   if (m_canvas)
     m_canvas->qWidget ()->setGeometry (0, 0, width (), height ());
 
-  gh_manager::auto_lock lock;
-
-  foreach (QObject* qObj, children ())
+  if (! m_childLayouts.isEmpty ())
     {
-      if (qObj->isWidgetType ())
-	{
-	  Object* obj = Object::fromQObject (qObj);
+      double w = width ();
+      double h = height ();
+
+      setUpdatesEnabled (false);
 
-	  if (obj)
-	    {
-	      Matrix bb = obj->properties ().get_boundingbox (false);
+      QHash<QObject*, ChildLayout>::const_iterator it;
 
-	      obj->qWidget<QWidget> ()
-		->setGeometry (xround (bb(0)), xround (bb(1)),
-			       xround (bb(2)), xround (bb(3)));
-	    }
+      for (it = m_childLayouts.constBegin ();
+	   it != m_childLayouts.constEnd (); ++it)
+	{
+	  const QRectF& r = it.value ().m_rect;
+	  QRectF bb;
+
+	  if (it.value ().m_normalized)
+	    bb = QRectF (r.x () * w, h - (r.y () + r.height ()) * h,
+			 r.width () * w, r.height () * h);
+	  else
+	    bb = QRectF (r.x (), h - r.y () - r.height (),
+			 r.width (), r.height ());
+
+	  static_cast<QWidget*> (it.key ())
+	    ->setGeometry (xround (bb.x ()), xround (bb.y ()),
+			   xround (bb.width ()), xround (bb.height ()));
 	}
+
+      setUpdatesEnabled (true);
     }
 }
 
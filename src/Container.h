@@ -22,10 +22,13 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef __QtHandles_Container__
 #define __QtHandles_Container__ 1
 
+#include <QHash>
+#include <QRectF>
 #include <QWidget>
 
 #include "GenericEventNotify.h"
 
+class base_properties;
 class graphics_handle;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -46,12 +49,26 @@ public:
   ~Container (void);
 
   Canvas* canvas (const graphics_handle& handle, bool create = true);
+  void setCanvas (Canvas* canvas);
+
+  void setChildLayout (QWidget* w, const base_properties& props);
 
 protected:
+  void childEvent (QChildEvent* event);
   void resizeEvent (QResizeEvent* event);
 
+private:
+  // Position of a child widget, bottom-left based. Either normalized to
+  // the container size, or in pixels.
+  struct ChildLayout
+  {
+    QRectF m_rect;
+    bool m_normalized;
+  };
+
 private:
   Canvas* m_canvas;
+  QHash<QObject*, ChildLayout> m_childLayouts;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -23,6 +23,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Backend.h"
 #include "ContextMenu.h"
+#include "EventWakeup.h"
 #include "Utils.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -100,15 +101,15 @@ void ContextMenu::update (int pId)
 
 void ContextMenu::aboutToShow (void)
 {
-  gh_manager::post_callback (m_handle, "callback");
-  gh_manager::post_set (m_handle, "visible", "on", false);
+  EventWakeup::postCallback (m_handle, "callback");
+  EventWakeup::postSet (m_handle, "visible", "on", false);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void ContextMenu::aboutToHide (void)
 {
-  gh_manager::post_set (m_handle, "visible", "off", false);
+  EventWakeup::postSet (m_handle, "visible", "off", false);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -20,9 +20,16 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <QLineEdit>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+
+#include <algorithm>
 
 #include "Container.h"
 #include "EditControl.h"
+#include "EventWakeup.h"
 #include "TextEdit.h"
 #include "Utils.h"
 
@@ -33,6 +40,53 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Splits every string on embedded newlines, so that each resulting line
+// maps to exactly one block of the text document.
+
+static string_vector splitLines (const string_vector& v)
+{
+  octave_idx_type n = v.length ();
+  octave_idx_type count = 0;
+
+  for (octave_idx_type i = 0; i < n; i++)
+    count += std::count (v[i].begin (), v[i].end (), '\n') + 1;
+
+  if (count == n)
+    return v;
+
+  string_vector lines (count);
+  octave_idx_type k = 0;
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      const std::string& s = v[i];
+      size_t start = 0, end;
+
+      while ((end = s.find ('\n', start)) != std::string::npos)
+	{
+	  lines[k++] = s.substr (start, end - start);
+	  start = end + 1;
+	}
+      lines[k++] = s.substr (start);
+    }
+
+  return lines;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static QString joinLines (const string_vector& lines, int first, int last)
+{
+  QStringList l;
+
+  for (int i = first; i < last; i++)
+    l << Utils::fromStdString (lines[i]);
+
+  return l.join ("\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 EditControl* EditControl::create (const graphics_object& go)
 {
   Object* parent = Object::parentObject (go);
@@ -58,7 +112,8 @@ EditControl* EditControl::create (const graphics_object& go)
 //////////////////////////////////////////////////////////////////////////////
 
 EditControl::EditControl (const graphics_object& go, QLineEdit* edit)
-     : BaseControl (go, edit), m_multiLine (false), m_textChanged (false)
+     : BaseControl (go, edit), m_multiLine (false), m_textChanged (false),
+       m_lines (), m_linesValid (false), m_updating (false)
 {
   init (edit);
 }
@@ -88,7 +143,8 @@ void EditControl::init (QLineEdit* edit, bool callBase)
 //////////////////////////////////////////////////////////////////////////////
 
 EditControl::EditControl (const graphics_object& go, TextEdit* edit)
-     : BaseControl (go, edit), m_multiLine (true), m_textChanged (false)
+     : BaseControl (go, edit), m_multiLine (true), m_textChanged (false),
+       m_lines (), m_linesValid (false), m_updating (false)
 {
   init (edit);
 }
@@ -106,9 +162,9 @@ void EditControl::init (TextEdit* edit, bool callBase)
   uicontrol::properties& up = properties<uicontrol> ();
 
   edit->setAcceptRichText (false);
-  // FIXME: support string_vector
-  edit->setPlainText (Utils::fromStdString (up.get_string_string ()));
-  
+  m_linesValid = false;
+  setMultiLineText (edit, up.get_string_vector ());
+
   connect (edit, SIGNAL (textChanged (void)),
 	   SLOT (textChanged (void)));
   connect (edit, SIGNAL (editingFinished (void)),
@@ -194,7 +250,7 @@ bool EditControl::updateMultiLine (int pId)
   switch (pId)
     {
     case uicontrol::properties::ID_STRING:
-      edit->setPlainText (Utils::fromStdString (up.get_string_string ()));
+      setMultiLineText (edit, up.get_string_vector ());
       return true;
     case uicontrol::properties::ID_MIN:
     case uicontrol::properties::ID_MAX:
@@ -215,8 +271,109 @@ bool EditControl::updateMultiLine (int pId)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void EditControl::setMultiLineText (TextEdit* edit,
+				    const string_vector& strings)
+{
+  // Only read through const references, the non-const operator[] would
+  // make private copies of the (shared) strings.
+  const string_vector lines = splitLines (strings);
+  const string_vector& oldLines = m_lines;
+  int oldCount = (m_linesValid ? m_lines.length () : 0);
+  int newCount = lines.length ();
+
+  m_updating = true;
+
+  if (oldCount == 0 || newCount == 0)
+    edit->setPlainText (joinLines (lines, 0, newCount));
+  else
+    {
+      int head = 0, tail = 0;
+
+      while (head < oldCount && head < newCount
+	     && oldLines[head] == lines[head])
+	head++;
+
+      while (tail < oldCount - head && tail < newCount - head
+	     && oldLines[oldCount-1-tail] == lines[newCount-1-tail])
+	tail++;
+
+      int oldEnd = oldCount - tail;
+      int newEnd = newCount - tail;
+
+      if (head < oldEnd || head < newEnd)
+	{
+	  // Edit through a separate cursor inside one edit block: only the
+	  // touched blocks are laid out again, and the view stays where it
+	  // was, unless it was following the end of an appended log.
+	  QScrollBar* sb = edit->verticalScrollBar ();
+	  int scroll = sb->value ();
+	  bool follow = (head == oldCount && scroll == sb->maximum ());
+	  QTextDocument* doc = edit->document ();
+	  QTextCursor cursor (doc);
+
+	  cursor.beginEditBlock ();
+	  if (head == oldCount)
+	    {
+	      // Lines appended at the end.
+	      cursor.movePosition (QTextCursor::End);
+	      cursor.insertText ("\n" + joinLines (lines, head, newEnd));
+	    }
+	  else if (head == oldEnd)
+	    {
+	      // Lines inserted before an existing line.
+	      cursor.setPosition (doc->findBlockByNumber (head).position ());
+	      cursor.insertText (joinLines (lines, head, newEnd) + "\n");
+	    }
+	  else if (head == newEnd)
+	    {
+	      // Lines removed.
+	      if (oldEnd < oldCount)
+		{
+		  QTextBlock first = doc->findBlockByNumber (head);
+		  QTextBlock next = doc->findBlockByNumber (oldEnd);
+
+		  cursor.setPosition (first.position ());
+		  cursor.setPosition (next.position (),
+				      QTextCursor::KeepAnchor);
+		}
+	      else
+		{
+		  QTextBlock last = doc->findBlockByNumber (head-1);
+
+		  cursor.setPosition (last.position () + last.length () - 1);
+		  cursor.movePosition (QTextCursor::End,
+				       QTextCursor::KeepAnchor);
+		}
+	      cursor.removeSelectedText ();
+	    }
+	  else
+	    {
+	      // Lines replaced.
+	      QTextBlock last = doc->findBlockByNumber (oldEnd-1);
+
+	      cursor.setPosition (doc->findBlockByNumber (head).position ());
+	      cursor.setPosition (last.position () + last.length () - 1,
+				  QTextCursor::KeepAnchor);
+	      cursor.insertText (joinLines (lines, head, newEnd));
+	    }
+	  cursor.endEditBlock ();
+
+	  sb->setValue (follow ? sb->maximum () : scroll);
+	}
+    }
+
+  m_lines = lines;
+  m_linesValid = true;
+  m_updating = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void EditControl::textChanged (void)
 {
+  if (! m_updating)
+    m_linesValid = false;
+
   m_textChanged = true;
 }
 
@@ -226,12 +383,46 @@ void EditControl::editingFinished (void)
 {
   if (m_textChanged)
     {
-      QString txt = (m_multiLine
-		     ? qWidget<TextEdit> ()->toPlainText ()
-		     : qWidget<QLineEdit> ()->text ());
+      if (m_multiLine)
+	{
+	  // Multi-line text goes back to octave with the type the property
+	  // already had: a cell array of lines, a char matrix, or a single
+	  // string with newlines.
+	  QString txt = qWidget<TextEdit> ()->toPlainText ();
+	  octave_value value;
+
+	  m_lines = Utils::toStringVector (txt.split ('\n'));
+	  m_linesValid = true;
+
+	  {
+	    gh_manager::auto_lock lock;
+	    graphics_object go = object ();
+
+	    if (go.valid_object ())
+	      {
+		octave_value old = Utils::properties<uicontrol> (go)
+		  .get_string ();
+
+		if (old.is_cell ())
+		  value = Cell (m_lines);
+		else if (old.rows () > 1)
+		  value = octave_value (m_lines, '\'');
+	      }
+	  }
+
+	  if (value.is_undefined ())
+	    value = Utils::toStdString (txt);
+
+	  EventWakeup::postSet (m_handle, "string", value, false);
+	}
+      else
+	{
+	  QString txt = qWidget<QLineEdit> ()->text ();
 
-      gh_manager::post_set (m_handle, "string", Utils::toStdString (txt), false);
-      gh_manager::post_callback (m_handle, "callback");
+	  EventWakeup::postSet (m_handle, "string", Utils::toStdString (txt),
+				false);
+	}
+      EventWakeup::postCallback (m_handle, "callback");
 
       m_textChanged = false;
     }
@@ -56,6 +56,7 @@ private:
   void initCommon (QWidget* widget);
   bool updateSingleLine (int pId);
   bool updateMultiLine (int pId);
+  void setMultiLineText (TextEdit* edit, const string_vector& lines);
 
 private slots:
   void textChanged (void);
@@ -64,6 +65,12 @@ private slots:
 private:
   bool m_multiLine;
   bool m_textChanged;
+
+  // Lines currently shown by the multi-line editor, used to apply string
+  // updates as a diff. Invalidated as soon as the user edits the text.
+  string_vector m_lines;
+  bool m_linesValid;
+  bool m_updating;
 };
 
 //////////////////////////////////////////////////////////////////////////////
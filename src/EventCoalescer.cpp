@@ -0,0 +1,154 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <map>
+#include <utility>
+
+#include "EventCoalescer.h"
+#include "EventWakeup.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct EventCoalescer::Event
+{
+  graphics_handle m_handle;
+  std::string m_property;
+  std::string m_callback;
+  octave_value m_value;
+  bool m_dirty;
+  bool m_detached;
+};
+
+typedef std::pair<double, std::string> EventKey;
+
+// Protected by the gh_manager lock.
+static std::map<EventKey, EventCoalescer::Event*> s_events;
+
+//////////////////////////////////////////////////////////////////////////////
+
+void EventCoalescer::post (const graphics_handle& h,
+			   const std::string& property,
+			   const octave_value& value,
+			   const std::string& callback)
+{
+  EventKey key (h.value (), property);
+  std::map<EventKey, Event*>::iterator it = s_events.find (key);
+
+  if (it != s_events.end ())
+    {
+      // A request is already pending, simply replace its value.
+      it->second->m_value = value;
+      it->second->m_callback = callback;
+      it->second->m_dirty = true;
+    }
+  else
+    {
+      Event* e = new Event ();
+
+      e->m_handle = h;
+      e->m_property = property;
+      e->m_callback = callback;
+      e->m_value = value;
+      e->m_dirty = true;
+      e->m_detached = false;
+
+      s_events[key] = e;
+
+      EventWakeup::postFunction (EventCoalescer::process, e);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void EventCoalescer::discard (const graphics_handle& h,
+			      const std::string& property)
+{
+  std::map<EventKey, Event*>::iterator it =
+    s_events.find (EventKey (h.value (), property));
+
+  // Detach the pending request: a value that is already queued is still
+  // delivered, as it precedes anything posted by the caller, but it is
+  // never re-posted, and later posts start a new request queued after
+  // the caller's events.
+  if (it != s_events.end ())
+    {
+      it->second->m_detached = true;
+      s_events.erase (it);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void EventCoalescer::process (void* data)
+{
+  Event* e = reinterpret_cast<Event*> (data);
+  bool execute = false;
+
+  // The callback itself is executed without holding the lock, otherwise
+  // the GUI thread would be blocked for the whole duration of the call.
+
+  {
+    gh_manager::auto_lock lock;
+
+    if (e->m_dirty)
+      {
+	graphics_object go = gh_manager::get_object (e->m_handle);
+
+	if (go.valid_object ())
+	  {
+	    property p = go.get_properties ().get_property (e->m_property);
+
+	    if (p.ok ())
+	      p.set (e->m_value, true, false);
+
+	    execute = ! e->m_callback.empty ();
+	  }
+
+	e->m_value = octave_value ();
+	e->m_dirty = false;
+      }
+  }
+
+  if (execute)
+    gh_manager::execute_callback (e->m_handle, e->m_callback);
+
+  gh_manager::auto_lock lock;
+
+  if (e->m_dirty && ! e->m_detached)
+    EventWakeup::postFunction (EventCoalescer::process, e);
+  else
+    {
+      // A detached request is no longer in s_events, its key may already
+      // belong to a newer one.
+      if (! e->m_detached)
+	s_events.erase (EventKey (e->m_handle.value (), e->m_property));
+      delete e;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
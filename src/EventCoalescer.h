@@ -0,0 +1,65 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __QtHandles_EventCoalescer__
+#define __QtHandles_EventCoalescer__ 1
+
+#include <string>
+
+#include <octave/oct.h>
+#include <octave/graphics.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Posts "set property, then execute callback" pairs to the octave thread,
+// merging consecutive requests for the same object and property. At most
+// one request is outstanding at a time: values posted while it's pending
+// (or while its callback runs) replace each other, and only the most
+// recent one is delivered once the previous callback has returned.
+//
+// All functions must be called with the gh_manager lock held.
+
+class EventCoalescer
+{
+public:
+  static void post (const graphics_handle& h, const std::string& property,
+		    const octave_value& value, const std::string& callback);
+
+  static void discard (const graphics_handle& h, const std::string& property);
+
+private:
+  struct Event;
+
+  static void process (void* data);
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,206 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <octave/oct.h>
+#include <octave/cmd-edit.h>
+#include <octave/graphics.h>
+
+#if defined (Q_OS_UNIX) && defined (USE_READLINE)
+#define QTHANDLES_EVENT_WAKEUP 1
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+extern "C" int rl_set_keyboard_input_timeout (int);
+#endif
+
+#include "EventWakeup.h"
+#include "Logger.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+#if defined (QTHANDLES_EVENT_WAKEUP)
+
+// Longest time the event hook blocks (ms)
+static const int s_timeout = 250;
+
+// readline default keyboard input timeout (us)
+static const int s_readlineTimeout = 100000;
+
+static int s_pipe[2] = { -1, -1 };
+
+// Protects the pending state below
+static QMutex s_mutex;
+static bool s_pending = false;
+static qint64 s_postTime = 0;
+static QElapsedTimer s_clock;
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+void EventWakeup::install (void)
+{
+#if defined (QTHANDLES_EVENT_WAKEUP)
+  if (s_pipe[0] < 0)
+    {
+      if (pipe (s_pipe) == 0)
+	{
+	  fcntl (s_pipe[0], F_SETFL, fcntl (s_pipe[0], F_GETFL) | O_NONBLOCK);
+	  fcntl (s_pipe[1], F_SETFL, fcntl (s_pipe[1], F_GETFL) | O_NONBLOCK);
+
+	  s_clock.start ();
+
+	  // readline must not wait for input itself, our hook does.
+	  rl_set_keyboard_input_timeout (0);
+	  command_editor::add_event_hook (EventWakeup::wait);
+	}
+      else
+	{
+	  s_pipe[0] = s_pipe[1] = -1;
+	  qWarning ("EventWakeup::install: unable to create pipe");
+	}
+    }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void EventWakeup::uninstall (void)
+{
+#if defined (QTHANDLES_EVENT_WAKEUP)
+  if (s_pipe[0] >= 0)
+    {
+      command_editor::remove_event_hook (EventWakeup::wait);
+      rl_set_keyboard_input_timeout (s_readlineTimeout);
+
+      QMutexLocker lock (&s_mutex);
+
+      close (s_pipe[0]);
+      close (s_pipe[1]);
+      s_pipe[0] = s_pipe[1] = -1;
+      s_pending = false;
+    }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void EventWakeup::notify (void)
+{
+#if defined (QTHANDLES_EVENT_WAKEUP)
+  QMutexLocker lock (&s_mutex);
+
+  if (! s_pending && s_pipe[1] >= 0)
+    {
+      s_pending = true;
+      s_postTime = s_clock.elapsed ();
+
+      char c = 0;
+
+      if (write (s_pipe[1], &c, 1) < 0 && errno != EAGAIN)
+	qWarning ("EventWakeup::notify: write failed");
+    }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+int EventWakeup::wait (void)
+{
+#if defined (QTHANDLES_EVENT_WAKEUP)
+  fd_set fds;
+  struct timeval tv;
+
+  FD_ZERO (&fds);
+  FD_SET (STDIN_FILENO, &fds);
+  FD_SET (s_pipe[0], &fds);
+
+  tv.tv_sec = s_timeout / 1000;
+  tv.tv_usec = (s_timeout % 1000) * 1000;
+
+  int n = select (qMax (STDIN_FILENO, s_pipe[0]) + 1, &fds, 0, 0, &tv);
+
+  if (n > 0 && FD_ISSET (s_pipe[0], &fds))
+    {
+      qint64 postTime;
+
+	{
+	  QMutexLocker lock (&s_mutex);
+	  char buf[64];
+
+	  while (read (s_pipe[0], buf, sizeof (buf)) > 0)
+	    ;
+
+	  s_pending = false;
+	  postTime = s_postTime;
+	}
+
+      gh_manager::process_events ();
+
+      Logger::debug ("EventWakeup::wait: events processed %d ms after post",
+		     static_cast<int> (s_clock.elapsed () - postTime));
+    }
+#endif
+
+  return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void EventWakeup::postCallback (const graphics_handle& h,
+				const std::string& name,
+				const octave_value& data)
+{
+  gh_manager::post_callback (h, name, data);
+  notify ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void EventWakeup::postFunction (graphics_event::event_fcn fcn, void* data)
+{
+  gh_manager::post_function (fcn, data);
+  notify ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void EventWakeup::postSet (const graphics_handle& h, const std::string& name,
+			   const octave_value& value, bool notify_toolkit)
+{
+  gh_manager::post_set (h, name, value, notify_toolkit);
+  notify ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
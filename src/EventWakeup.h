@@ -0,0 +1,76 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __QtHandles_EventWakeup__
+#define __QtHandles_EventWakeup__ 1
+
+#include <string>
+
+#include <octave/oct.h>
+#include <octave/graphics.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Posts work to the octave thread and wakes it up right away.
+//
+// Octave only processes posted graphics events from the readline event
+// hook, which is polled every 100ms while waiting for input. Once
+// installed, the event hook instead blocks until either input is
+// available or some work has been posted through this class, so posted
+// callbacks run immediately and an idle octave doesn't spin. A bounded
+// timeout keeps events posted by other means flowing.
+//
+// Only available on Unix with readline, elsewhere posting falls back to
+// the plain gh_manager functions.
+
+class EventWakeup
+{
+public:
+  static void install (void);
+  static void uninstall (void);
+
+  static void postCallback (const graphics_handle& h,
+			    const std::string& name,
+			    const octave_value& data = Matrix ());
+
+  static void postFunction (graphics_event::event_fcn fcn, void* data = 0);
+
+  static void postSet (const graphics_handle& h, const std::string& name,
+		       const octave_value& value, bool notify_toolkit = true);
+
+private:
+  static void notify (void);
+
+  static int wait (void);
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -28,16 +28,22 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMainWindow>
 #include <QMenu>
 #include <QMenuBar>
+#include <QMap>
 #include <QMessageBox>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QtDebug>
 #include <QTimer>
 #include <QToolBar>
 
+#include "Backend.h"
 #include "Canvas.h"
 #include "Container.h"
+#include "EventWakeup.h"
 #include "Figure.h"
 #include "FigureWindow.h"
 #include "MouseModeActionGroup.h"
+#include "Panel.h"
 #include "Utils.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -57,35 +63,26 @@ DECLARE_GENERICEVENTNOTIFY_SENDER(MenuBar, QMenuBar);
 
 static bool hasUiControlChildren (const figure::properties& fp)
 {
-  Matrix kids = fp.get_all_children ();
-
-  for (int i = 0; i < kids.numel (); i++)
-    {
-      graphics_object go (gh_manager::get_object (kids(i)));
-
-      if (go && (go.isa ("uicontrol") || go.isa ("uipanel")
-		 || go.isa ("uibuttongroup")))
-	return true;
-    }
-
-  return false;
+  return Backend::uiControlChildCount (fp.get___myhandle__ ()) > 0;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 static bool hasUiMenuChildren (const figure::properties& fp)
 {
-  Matrix kids = fp.get_all_children ();
+  return Backend::uiMenuChildCount (fp.get___myhandle__ ()) > 0;
+}
 
-  for (int i = 0; i < kids.numel (); i++)
-    {
-      graphics_object go (gh_manager::get_object (kids(i)));
+//////////////////////////////////////////////////////////////////////////////
 
-      if (go && go.isa ("uimenu"))
-	return true;
-    }
+// A registered panel stays alive until its deleteLater runs after it has
+// been finalized or released, but its widget or graphics object may
+// already be gone. Must be called with the gh_manager lock held.
 
-  return false;
+static bool isLivePanel (Panel* panel)
+{
+  return (panel && panel->qObject ()
+	  && panel->object ().valid_object ());
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -109,7 +106,7 @@ static QRect boundingBoxToRect (const Matrix& bb)
 
 Figure* Figure::create (const graphics_object& go)
 {
-  return new Figure (go, new FigureWindow ());
+  return new Figure (go, FigureWindowPool::take ());
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -117,25 +114,38 @@ Figure* Figure::create (const graphics_object& go)
 Figure::Figure (const graphics_object& go, FigureWindow* win)
      : Object (go, win), m_blockUpdates (false), m_mouseMode (NoMode),
        m_lastMouseMode (NoMode), m_figureToolBar (0), m_menuBar (0),
-       m_innerRect (), m_outerRect ()
+       m_mouseModeGroup (0), m_builtinMenus (false),
+       m_innerRect (), m_outerRect (), m_redrawTimer (0),
+       m_resizing (false), m_resizeSyncPending (false), m_resizeTimer (0)
 {
-  m_container = new Container (win);
-  win->setCentralWidget (m_container);
+  m_container = dynamic_cast<Container*> (win->centralWidget ());
+  if (! m_container)
+    {
+      m_container = new Container (win);
+      win->setCentralWidget (m_container);
+    }
 
   figure::properties& fp = properties<figure> ();
 
-  createFigureToolBarAndMenuBar ();
-
+  // The figure toolbar and the menubar are only created when they are
+  // about to be shown.
   int offset = 0;
   if (fp.toolbar_is ("figure")
       || (fp.toolbar_is ("auto") && ! hasUiControlChildren (fp)))
-    offset += m_figureToolBar->sizeHint ().height ();
-  else
-    m_figureToolBar->hide ();
+    {
+      createFigureToolBar ();
+      m_figureToolBar->show ();
+      offset += m_figureToolBar->sizeHint ().height ();
+    }
   if (fp.menubar_is ("figure") || hasUiMenuChildren (fp))
-    offset += m_menuBar->sizeHint ().height () + 1;
-  else
-    m_menuBar->hide ();
+    {
+      if (fp.menubar_is ("figure"))
+	createBuiltinMenus ();
+      else
+	createMenuBar ();
+      m_menuBar->show ();
+      offset += m_menuBar->sizeHint ().height () + 1;
+    }
 
   m_innerRect = boundingBoxToRect (fp.get_boundingbox (true));
   m_outerRect = boundingBoxToRect (fp.get_boundingbox (false));
@@ -150,8 +160,22 @@ Figure::Figure (const graphics_object& go, FigureWindow* win)
     eventMask |= Canvas::KeyPress;
   if (! fp.get_keyreleasefcn ().is_empty ())
     eventMask |= Canvas::KeyRelease;
+  if (! fp.get_windowbuttonmotionfcn ().is_empty ())
+    eventMask |= Canvas::ButtonMotion;
   m_container->canvas (m_handle)->setEventMask (eventMask);
 
+  m_redrawTimer = new QTimer (this);
+  m_redrawTimer->setSingleShot (true);
+  m_redrawTimer->setInterval (100);
+  connect (m_redrawTimer, SIGNAL (timeout (void)),
+	   this, SLOT (slotRedraw (void)));
+
+  m_resizeTimer = new QTimer (this);
+  m_resizeTimer->setSingleShot (true);
+  m_resizeTimer->setInterval (150);
+  connect (m_resizeTimer, SIGNAL (timeout (void)),
+	   this, SLOT (endResize (void)));
+
   connect (this, SIGNAL (asyncUpdate (void)),
            this, SLOT (updateContainer (void)));
 
@@ -160,8 +184,11 @@ Figure::Figure (const graphics_object& go, FigureWindow* win)
   else
     win->hide ();
 
-  win->addReceiver (this);
-  m_container->addReceiver (this);
+  win->addReceiver (this, QEvent::Close);
+  win->addReceiver (this, QEvent::Move);
+  win->addReceiver (this, QEvent::Resize);
+  m_container->addReceiver (this, QEvent::Resize);
+  m_container->addReceiver (this, QEvent::ChildAdded);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -172,24 +199,92 @@ Figure::~Figure (void)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Figure::createFigureToolBarAndMenuBar (void)
+MouseModeActionGroup* Figure::mouseModeGroup (void)
 {
-  QMainWindow* win = qWidget<QMainWindow> ();
+  if (! m_mouseModeGroup)
+    {
+      m_mouseModeGroup = new MouseModeActionGroup (qWidget<QMainWindow> ());
+      connect (m_mouseModeGroup, SIGNAL (modeChanged (MouseMode)),
+	       SLOT (setMouseMode (MouseMode)));
+    }
 
-  m_figureToolBar = win->addToolBar (tr ("Figure ToolBar"));
-  m_figureToolBar->setMovable (false);
-  m_figureToolBar->setFloatable (false);
+  return m_mouseModeGroup;
+}
 
-  MouseModeActionGroup* mouseModeGroup = new MouseModeActionGroup (win);
-  connect (mouseModeGroup, SIGNAL (modeChanged (MouseMode)),
-	   SLOT (setMouseMode (MouseMode)));
-  m_figureToolBar->addActions (mouseModeGroup->actions ());
+//////////////////////////////////////////////////////////////////////////////
 
-  m_menuBar = new MenuBar (win);
-  win->setMenuBar (m_menuBar);
+void Figure::createFigureToolBar (void)
+{
+  // The toolbar is created hidden, see showFigureToolBar.
 
-  QMenu* fileMenu = m_menuBar->addMenu (tr ("&File"));
+  if (! m_figureToolBar)
+    {
+      QMainWindow* win = qWidget<QMainWindow> ();
+
+      m_figureToolBar = new QToolBar (tr ("Figure ToolBar"), win);
+      m_figureToolBar->setMovable (false);
+      m_figureToolBar->setFloatable (false);
+      m_figureToolBar->hide ();
+      m_figureToolBar->addActions (mouseModeGroup ()->actions ());
+
+      // Keep it above the uitoolbars already present.
+      QToolBar* first = 0;
+
+      foreach (QToolBar* tb, win->findChildren<QToolBar*> ())
+	if (tb != m_figureToolBar
+	    && win->toolBarArea (tb) == Qt::TopToolBarArea)
+	  {
+	    first = tb;
+	    break;
+	  }
+
+      if (first)
+	{
+	  win->insertToolBar (first, m_figureToolBar);
+	  win->insertToolBarBreak (first);
+	}
+      else
+	win->addToolBar (m_figureToolBar);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Figure::createMenuBar (void)
+{
+  // The menubar is created hidden and empty, see showMenuBar and
+  // createBuiltinMenus.
+
+  if (! m_menuBar)
+    {
+      QMainWindow* win = qWidget<QMainWindow> ();
+
+      m_menuBar = new MenuBar (win);
+      m_menuBar->hide ();
+      win->setMenuBar (m_menuBar);
+
+      m_menuBar->addReceiver (this, QEvent::ActionAdded);
+      m_menuBar->addReceiver (this, QEvent::ActionRemoved);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Figure::createBuiltinMenus (void)
+{
+  if (m_builtinMenus)
+    return;
+
+  createMenuBar ();
+
+  m_builtinMenus = true;
+
+  // Built-in menus go before any uimenu already present.
+  QAction* before = m_menuBar->actions ().value (0, 0);
+
+  QMenu* fileMenu = new QMenu (tr ("&File"), m_menuBar);
   fileMenu->menuAction ()->setObjectName ("builtinMenu");
+  m_menuBar->insertMenu (before, fileMenu);
   fileMenu->addAction (tr ("&New Figure"), this, SLOT (fileNewFigure (void)));
   fileMenu->addAction (tr ("&Open..."))->setEnabled (false);
   fileMenu->addSeparator ();
@@ -199,8 +294,9 @@ void Figure::createFigureToolBarAndMenuBar (void)
   fileMenu->addAction (tr ("&Close Figure"), this,
 		       SLOT (fileCloseFigure (void)), Qt::CTRL|Qt::Key_W);
 
-  QMenu* editMenu = m_menuBar->addMenu (tr ("&Edit"));
+  QMenu* editMenu = new QMenu (tr ("&Edit"), m_menuBar);
   editMenu->menuAction ()->setObjectName ("builtinMenu");
+  m_menuBar->insertMenu (before, editMenu);
   editMenu->addAction (tr ("Cop&y"), this, SLOT (editCopy (void)),
 		       Qt::CTRL|Qt::Key_C)->setEnabled (false);
   editMenu->addAction (tr ("Cu&t"), this, SLOT (editCut (void)),
@@ -208,15 +304,14 @@ void Figure::createFigureToolBarAndMenuBar (void)
   editMenu->addAction (tr ("&Paste"), this, SLOT (editPaste(void)),
 		       Qt::CTRL|Qt::Key_V)->setEnabled (false);
   editMenu->addSeparator ();
-  editMenu->addActions (mouseModeGroup->actions ());
+  editMenu->addActions (mouseModeGroup ()->actions ());
 
-  QMenu* helpMenu = m_menuBar->addMenu (tr ("&Help"));
+  QMenu* helpMenu = new QMenu (tr ("&Help"), m_menuBar);
   helpMenu->menuAction ()->setObjectName ("builtinMenu");
+  m_menuBar->insertMenu (before, helpMenu);
   helpMenu->addAction (tr ("&About QtHandles"), this,
 		       SLOT (helpAboutQtHandles (void)));
   helpMenu->addAction (tr ("About &Qt"), qApp, SLOT (aboutQt (void)));
-
-  m_menuBar->addReceiver (this);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -238,18 +333,36 @@ void Figure::redraw (void)
     //canvas->setMouseMode (RotateMode);
     }
 
-  foreach (QFrame* frame,
-	   qWidget<QWidget> ()->findChildren<QFrame*> ("UIPanel"))
-    {
-      Object* obj = Object::fromQObject (frame);
+  gh_manager::auto_lock lock;
+
+  QList<QPointer<Panel> >::iterator it = m_panels.begin ();
 
-      if (obj)
-	obj->slotRedraw ();
+  while (it != m_panels.end ())
+    {
+      if (*it)
+	{
+	  if (isLivePanel (*it))
+	    (*it)->slotRedraw ();
+	  ++it;
+	}
+      else
+	it = m_panels.erase (it);
     }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Figure::addPanel (Panel* panel)
+{
+  // Panels are registered when created, parents before children. The
+  // entries of deleted panels are cleared automatically and dropped on
+  // the next redraw.
+
+  m_panels.append (panel);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Figure::beingDeleted (void)
 {
   Canvas* canvas = m_container->canvas (m_handle.value (), false);
@@ -257,7 +370,8 @@ void Figure::beingDeleted (void)
   if (canvas)
     canvas->blockRedraw (true);
 
-  m_menuBar->removeReceiver (this);
+  if (m_menuBar)
+    m_menuBar->removeReceiver (this);
   m_container->removeReceiver (this);
   qWidget<FigureWindow> ()->removeReceiver (this);
 }
@@ -285,7 +399,7 @@ void Figure::update (int pId)
           foreach (QToolBar* tb, win->findChildren<QToolBar*> ())
             if (! tb->isHidden ())
               offset += tb->sizeHint ().height ();
-	  if (! m_menuBar->isHidden ())
+	  if (m_menuBar && ! m_menuBar->isHidden ())
 	    offset += m_menuBar->sizeHint ().height () + 1;
           //qDebug () << "Figure::update(position)(adjusted):" << m_innerRect.adjusted (0, -offset, 0, 0);
 	  win->setGeometry (m_innerRect.adjusted (0, -offset, 0, 0));
@@ -325,6 +439,12 @@ void Figure::update (int pId)
       else
         m_container->canvas (m_handle)->addEventMask (Canvas::KeyRelease);
       break;
+    case figure::properties::ID_WINDOWBUTTONMOTIONFCN:
+      if (fp.get_windowbuttonmotionfcn ().is_empty ())
+        m_container->canvas (m_handle)->clearEventMask (Canvas::ButtonMotion);
+      else
+        m_container->canvas (m_handle)->addEventMask (Canvas::ButtonMotion);
+      break;
     default:
       break;
     }
@@ -336,6 +456,14 @@ void Figure::update (int pId)
 
 void Figure::showFigureToolBar (bool visible)
 {
+  if (! m_figureToolBar)
+    {
+      if (! visible)
+	return;
+
+      createFigureToolBar ();
+    }
+
   if ((! m_figureToolBar->isHidden ()) != visible)
     {
       int dy = m_figureToolBar->sizeHint ().height ();
@@ -367,6 +495,11 @@ void Figure::showFigureToolBar (bool visible)
 
 void Figure::showMenuBar (bool visible)
 {
+  if (visible)
+    createBuiltinMenus ();
+  else if (! m_menuBar)
+    return;
+
   int h1 = m_menuBar->sizeHint ().height ();
 
   foreach (QAction* a, m_menuBar->actions ())
@@ -414,45 +547,76 @@ void Figure::updateMenuBar (void)
 
 QWidget* Figure::menu (void)
 {
-  return qWidget<QMainWindow> ()->menuBar ();
+  createMenuBar ();
+
+  return m_menuBar;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Bounding boxes waiting to be sent to octave, indexed by figure handle.
+// An entry exists while a call to updateBoundingBoxHelper is pending for
+// the figure, newer geometry simply replaces the pending one.
+
 struct UpdateBoundingBoxData
 {
-  Matrix m_bbox;
-  bool m_internal;
-  graphics_handle m_handle;
-  Figure* m_figure;
+  Matrix m_innerBox;
+  Matrix m_outerBox;
 };
 
-void Figure::updateBoundingBoxHelper (void* data)
+static QMutex s_boundingBoxMutex;
+static QMap<double, UpdateBoundingBoxData> s_boundingBoxData;
+
+void Figure::updateBoundingBoxHelper (void* /* data */)
 {
+  QMap<double, UpdateBoundingBoxData> pending;
+
+    {
+      QMutexLocker lock (&s_boundingBoxMutex);
+
+      pending = s_boundingBoxData;
+      s_boundingBoxData.clear ();
+    }
+
   gh_manager::auto_lock lock;
 
-  UpdateBoundingBoxData* d = reinterpret_cast<UpdateBoundingBoxData*> (data);
-  graphics_object go = gh_manager::get_object (d->m_handle);
+  QMap<double, UpdateBoundingBoxData>::const_iterator it;
 
-  if (go.valid_object ())
+  for (it = pending.constBegin (); it != pending.constEnd (); ++it)
     {
-      figure::properties& fp = Utils::properties<figure> (go);
+      graphics_handle h (it.key ());
+      graphics_object go = gh_manager::get_object (h);
 
-      //qDebug ("Figure::updateBoundingBoxHelper: internal=%d, bbox=[%g %g %g %g]",
-      //        d->m_internal, d->m_bbox(0), d->m_bbox(1), d->m_bbox(2), d->m_bbox(3));
-      fp.set_boundingbox (d->m_bbox, d->m_internal, false);
+      if (go.valid_object ())
+	{
+	  figure::properties& fp = Utils::properties<figure> (go);
+	  const UpdateBoundingBoxData& d = it.value ();
 
-      if (d->m_internal)
-        emit d->m_figure->asyncUpdate ();
-    }
+	  if (! d.m_outerBox.is_empty ())
+	    fp.set_boundingbox (d.m_outerBox, false, false);
 
-  delete d;
+	  if (! d.m_innerBox.is_empty ())
+	    {
+	      fp.set_boundingbox (d.m_innerBox, true, false);
+
+	      Figure* fig = dynamic_cast<Figure*> (Backend::toolkitObject (go));
+
+	      if (fig)
+		emit fig->asyncUpdate ();
+	    }
+	}
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Figure::updateBoundingBox (bool internal, int flags)
+bool Figure::updateBoundingBox (bool internal, int flags)
 {
+  // Size changes are held until an interactive resize ends, see
+  // beginResize.
+  if (m_resizing && (flags & UpdateBoundingBoxSize))
+    return false;
+
   QWidget* win = qWidget<QWidget> ();
   Matrix bb (1, 4);
 
@@ -476,7 +640,7 @@ void Figure::updateBoundingBox (bool internal, int flags)
           bb(3) = r.height ();
         }
       else
-        return;
+        return false;
     }
   else
     {
@@ -498,19 +662,25 @@ void Figure::updateBoundingBox (bool internal, int flags)
           bb(3) = r.height ();
         }
       else
-        return;
+        return false;
     }
 
-  UpdateBoundingBoxData* d = new UpdateBoundingBoxData ();
+  QMutexLocker lock (&s_boundingBoxMutex);
 
-  d->m_bbox = bb;
-  d->m_internal = internal;
-  d->m_handle = m_handle;
-  d->m_figure = this;
+  bool post = ! s_boundingBoxData.contains (m_handle.value ());
+  UpdateBoundingBoxData& d = s_boundingBoxData[m_handle.value ()];
+
+  if (internal)
+    d.m_innerBox = bb;
+  else
+    d.m_outerBox = bb;
 
   //qDebug ("Figure::updateBoundingBox: internal=%d, bbox=[%g %g %g %g]",
-  //        d->m_internal, d->m_bbox(0), d->m_bbox(1), d->m_bbox(2), d->m_bbox(3));
-  gh_manager::post_function (Figure::updateBoundingBoxHelper, d);
+  //        internal, bb(0), bb(1), bb(2), bb(3));
+  if (post)
+    EventWakeup::postFunction (Figure::updateBoundingBoxHelper);
+
+  return true;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -546,7 +716,7 @@ bool Figure::eventNotifyBefore (QObject* obj, QEvent* event)
 	    {
 	    case QEvent::Close:
 	      event->ignore ();
-	      gh_manager::post_callback (m_handle, "closerequestfcn");
+	      EventWakeup::postCallback (m_handle, "closerequestfcn");
 	      return true;
 	    default:
 	      break;
@@ -568,7 +738,8 @@ void Figure::eventNotifyAfter (QObject* watched, QEvent* event)
 	  switch (event->type ())
 	    {
 	    case QEvent::Resize:
-	      updateBoundingBox (true, UpdateBoundingBoxSize);
+	      if (! beginResize ())
+		updateBoundingBox (true, UpdateBoundingBoxSize);
 	      break;
 	    case QEvent::ChildAdded:
 	      if (dynamic_cast<QChildEvent*> (event)->child
@@ -577,7 +748,8 @@ void Figure::eventNotifyAfter (QObject* watched, QEvent* event)
 		  gh_manager::auto_lock lock;
 		  const figure::properties& fp = properties<figure> ();
 
-		  showFigureToolBar (! hasUiControlChildren (fp));
+		  if (fp.toolbar_is ("auto"))
+		    showFigureToolBar (! hasUiControlChildren (fp));
 		}
 	    default:
 	      break;
@@ -609,7 +781,8 @@ void Figure::eventNotifyAfter (QObject* watched, QEvent* event)
 	      updateBoundingBox (true, UpdateBoundingBoxPosition);
 	      break;
 	    case QEvent::Resize:
-	      updateBoundingBox (false, UpdateBoundingBoxSize);
+	      if (! beginResize ())
+		updateBoundingBox (false, UpdateBoundingBoxSize);
 	      break;
 	    default:
 	      break;
@@ -713,7 +886,96 @@ void Figure::showCustomToolBar (QToolBar* bar, bool visible)
 
 void Figure::updateContainer (void)
 {
-  redraw ();
+  if (m_resizing)
+    {
+      // Redrawn when the resize ends.
+    }
+  else if (m_resizeSyncPending)
+    {
+      // Octave now has the final geometry of an interactive resize.
+      m_resizeSyncPending = false;
+
+      gh_manager::auto_lock lock;
+
+      foreach (Panel* panel, m_panels)
+	if (isLivePanel (panel) && panel->qWidget<QWidget> ()->isVisible ())
+	  panel->properties ().update_boundingbox ();
+
+      setCanvasesResizing (false);
+      redraw ();
+    }
+  else
+    {
+      // Wait for the geometry to settle before redrawing.
+      m_redrawTimer->start ();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool Figure::beginResize (void)
+{
+  // While the window is being resized interactively, only the Qt side
+  // follows: the canvases show their last frame scaled and the octave
+  // geometry is left alone. Once no resize event has been received for
+  // a short while, the geometry is sent to octave and the figure is
+  // rendered again, see endResize.
+  //
+  // Resizes of a hidden window, or before anything has been drawn (first
+  // show, window manager placement), are not interactive: return false,
+  // the caller then syncs the geometry right away.
+
+  if (! m_resizing)
+    {
+      Canvas* canvas = m_container->canvas (m_handle, false);
+
+      if (! qWidget<QWidget> ()->isVisible () || ! canvas)
+	return false;
+
+      canvas->setResizing (true);
+      if (! canvas->isResizing ())
+	return false;
+
+      m_resizing = true;
+      setCanvasesResizing (true);
+    }
+
+  m_resizeTimer->start ();
+
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Figure::endResize (void)
+{
+  m_resizing = false;
+
+  updateBoundingBox (false, UpdateBoundingBoxSize);
+
+  if (updateBoundingBox (true, UpdateBoundingBoxSize))
+    m_resizeSyncPending = true;
+  else
+    {
+      setCanvasesResizing (false);
+      slotRedraw ();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Figure::setCanvasesResizing (bool resizing)
+{
+  Canvas* canvas = m_container->canvas (m_handle, false);
+
+  if (canvas)
+    canvas->setResizing (resizing);
+
+  gh_manager::auto_lock lock;
+
+  foreach (Panel* panel, m_panels)
+    if (isLivePanel (panel) && (canvas = panel->canvas ()))
+      canvas->setResizing (resizing);
 }
 
 //////////////////////////////////////////////////////////////////////////////
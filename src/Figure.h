@@ -22,6 +22,8 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef __QtHandles_Figure__
 #define __QtHandles_Figure__ 1
 
+#include <QList>
+#include <QPointer>
 #include <QRect>
 
 #include "GenericEventNotify.h"
@@ -29,6 +31,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #include "Object.h"
 
 class QMainWindow;
+class QTimer;
 class QToolBar;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -52,6 +55,8 @@ enum MouseMode
 class Container;
 class FigureWindow;
 class MenuBar;
+class MouseModeActionGroup;
+class Panel;
 class ToolBar;
 
 class Figure :
@@ -74,6 +79,10 @@ public:
   Container* innerContainer (void);
   QWidget* menu (void);
 
+  void addPanel (Panel* panel);
+
+  bool isResizing (void) const { return m_resizing; }
+
   bool eventNotifyBefore (QObject* watched, QEvent* event);
   void eventNotifyAfter (QObject* watched, QEvent* event);
 
@@ -88,13 +97,18 @@ protected:
 protected:
   void redraw (void);
   void update (int pId);
-  void updateBoundingBox (bool internal = false, int flags = 0);
+  bool updateBoundingBox (bool internal = false, int flags = 0);
   void beingDeleted (void);
 
 private:
-  void createFigureToolBarAndMenuBar (void);
+  void createFigureToolBar (void);
+  void createMenuBar (void);
+  void createBuiltinMenus (void);
+  MouseModeActionGroup* mouseModeGroup (void);
   void showFigureToolBar (bool visible);
   void showMenuBar (bool visible);
+  bool beginResize (void);
+  void setCanvasesResizing (bool resizing);
   void addCustomToolBar (QToolBar* bar, bool visible);
   void showCustomToolBar (QToolBar* bar, bool visible);
 
@@ -110,6 +124,7 @@ private slots:
   void helpAboutQtHandles (void);
   void updateMenuBar (void);
   void updateContainer (void);
+  void endResize (void);
 
 signals:
   void asyncUpdate (void);
@@ -120,8 +135,15 @@ private:
   MouseMode m_mouseMode, m_lastMouseMode;
   QToolBar* m_figureToolBar;
   MenuBar* m_menuBar;
+  MouseModeActionGroup* m_mouseModeGroup;
+  bool m_builtinMenus;
   QRect m_innerRect;
   QRect m_outerRect;
+  QTimer* m_redrawTimer;
+  bool m_resizing;
+  bool m_resizeSyncPending;
+  QTimer* m_resizeTimer;
+  QList<QPointer<Panel> > m_panels;
 };
 
 //////////////////////////////////////////////////////////////////////////////
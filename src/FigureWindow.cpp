@@ -19,9 +19,16 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 */
 
+#include <QApplication>
 #include <QMenu>
+#include <QProcessEnvironment>
+#include <QThread>
+#include <QTimer>
 
+#include "Canvas.h"
+#include "Container.h"
 #include "FigureWindow.h"
+#include "Logger.h"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -51,4 +58,105 @@ QMenu* FigureWindow::createPopupMenu (void)
 
 //////////////////////////////////////////////////////////////////////////////
 
+FigureWindowPool::FigureWindowPool (void)
+  : QObject (), m_size (1), m_refillPending (false)
+{
+  QProcessEnvironment pe (QProcessEnvironment::systemEnvironment ());
+  bool ok;
+  int size = pe.value ("QTHANDLES_FIGURE_POOL", "1").toInt (&ok);
+
+  if (ok && size >= 0)
+    m_size = size;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+FigureWindowPool* FigureWindowPool::instance (void)
+{
+  static FigureWindowPool s_instance;
+  static bool s_instanceCreated = false;
+
+  if (! s_instanceCreated)
+    {
+      if (QThread::currentThread () != QApplication::instance ()->thread ())
+	s_instance.moveToThread (QApplication::instance ()->thread ());
+      s_instanceCreated = true;
+    }
+
+  return &s_instance;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+FigureWindow* FigureWindowPool::build (void)
+{
+  FigureWindow* win = new FigureWindow ();
+  Container* container = new Container (win);
+
+  win->setCentralWidget (container);
+
+  // The canvas is attached to its figure when the window is taken.
+  container->setCanvas (Canvas::create ("opengl", container,
+					graphics_handle ()));
+
+  return win;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+FigureWindow* FigureWindowPool::take (void)
+{
+  FigureWindowPool* pool = instance ();
+
+  if (pool->m_size > 0)
+    {
+      if (! pool->m_refillPending)
+	{
+	  pool->m_refillPending = true;
+	  QTimer::singleShot (0, pool, SLOT (refill (void)));
+	}
+
+      if (! pool->m_windows.isEmpty ())
+	return pool->m_windows.takeFirst ();
+
+      Logger::debug ("FigureWindowPool::take: pool is empty");
+    }
+
+  return new FigureWindow ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FigureWindowPool::refill (void)
+{
+  // Build one window at a time, going back to the event loop in between
+  // to keep the GUI responsive.
+
+  m_refillPending = false;
+
+  if (m_windows.size () < m_size)
+    {
+      m_windows.append (build ());
+
+      Logger::debug ("FigureWindowPool::refill: %d/%d windows",
+		     m_windows.size (), m_size);
+
+      if (m_windows.size () < m_size)
+	{
+	  m_refillPending = true;
+	  QTimer::singleShot (0, this, SLOT (refill (void)));
+	}
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FigureWindowPool::clear (void)
+{
+  qDeleteAll (m_windows);
+  m_windows.clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 }; // namespace QtHandles
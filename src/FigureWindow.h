@@ -22,6 +22,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef __QtHandles_FigureWindow__
 #define __QtHandles_FigureWindow__ 1
 
+#include <QList>
 #include <QMainWindow>
 
 #include "GenericEventNotify.h"
@@ -48,6 +49,37 @@ public:
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Hidden figure windows, with their container and canvas, built ahead of
+// time in the GUI thread, so that figure creation does not have to pay
+// for the window and OpenGL context setup. The number of windows kept
+// is given by QTHANDLES_FIGURE_POOL (default 1, 0 disables the pool).
+
+class FigureWindowPool : public QObject
+{
+  Q_OBJECT
+
+public:
+  static FigureWindowPool* instance (void);
+
+  static FigureWindow* take (void);
+
+public slots:
+  void refill (void);
+  void clear (void);
+
+private:
+  FigureWindowPool (void);
+
+  static FigureWindow* build (void);
+
+private:
+  QList<FigureWindow*> m_windows;
+  int m_size;
+  bool m_refillPending;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 }; // namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
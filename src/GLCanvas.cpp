@@ -24,6 +24,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #include <octave/graphics.h>
 
 #include "GLCanvas.h"
+#include "RenderThread.h"
 #include "gl-select.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -33,16 +34,148 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+static QGLWidget* shareWidget (void)
+{
+  // Hidden widget owning the context shared by all canvases, so that
+  // display lists and textures are created once per process.
+
+  static QGLWidget* s_shareWidget = 0;
+
+  if (! s_shareWidget)
+    s_shareWidget = new QGLWidget ();
+
+  return s_shareWidget;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 GLCanvas::GLCanvas (QWidget* parent, const graphics_handle& handle)
-  : QGLWidget (parent), Canvas (handle)
+  : QGLWidget (parent, shareWidget ()), Canvas (handle), m_renderThread (0),
+    m_frameDrawn (false)
 {
   setFocusPolicy (Qt::ClickFocus);
+
+  if (RenderThread::enabled ())
+    {
+      m_renderThread = new RenderThread (this);
+      m_renderThread->start ();
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 GLCanvas::~GLCanvas (void)
 {
+  if (m_renderThread)
+    m_renderThread->stop ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool GLCanvas::requestFrame (void)
+{
+  if (m_renderThread)
+    {
+      m_renderThread->requestFrame (handle (), size ());
+      return true;
+    }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool GLCanvas::drawFrame (void)
+{
+  // Threaded mode: copy the last frame rendered by the render thread to
+  // the screen. A frame of the wrong size means the canvas has been
+  // resized (or nothing was rendered yet), so ask for a new one.
+
+  if (! m_renderThread)
+    return false;
+
+  QImage frame;
+
+  m_renderThread->frame (frame);
+
+  if (frame.size () != size ())
+    m_renderThread->requestFrame (handle (), size ());
+
+  drawImage (frame, false);
+
+  if (! frame.isNull ())
+    m_frameDrawn = true;
+
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GLCanvas::drawImage (const QImage& img, bool fit)
+{
+  // Draw an image in GL format at the bottom-left corner of the canvas,
+  // or centered and scaled to fit it while keeping its aspect ratio.
+
+  glViewport (0, 0, width (), height ());
+
+  glMatrixMode (GL_MODELVIEW);
+  glLoadIdentity ();
+
+  glMatrixMode (GL_PROJECTION);
+  glLoadIdentity ();
+  glOrtho (0, width (), 0, height (), -1, 1);
+
+  if (img.isNull () || img.size () != size ())
+    {
+      qglClearColor (palette ().color (QPalette::Window));
+      glClear (GL_COLOR_BUFFER_BIT);
+    }
+
+  if (! img.isNull ())
+    {
+      double scale = 1.0;
+      int x = 0, y = 0;
+
+      if (fit)
+	{
+	  scale = qMin (double (width ()) / img.width (),
+			double (height ()) / img.height ());
+	  x = xround ((width () - scale * img.width ()) / 2);
+	  y = xround ((height () - scale * img.height ()) / 2);
+	}
+
+      glPushAttrib (GL_DEPTH_BUFFER_BIT);
+      glDisable (GL_DEPTH_TEST);
+
+      glRasterPos2i (x, y);
+      glPixelZoom (scale, scale);
+      glDrawPixels (img.width (), img.height (), GL_RGBA,
+		    GL_UNSIGNED_BYTE, img.bits ());
+      glPixelZoom (1, 1);
+
+      glPopAttrib ();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool GLCanvas::grabFrame (void)
+{
+  if (m_frameDrawn)
+    {
+      m_grabbedFrame = convertToGLFormat (grabFrameBuffer ());
+
+      return ! m_grabbedFrame.isNull ();
+    }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GLCanvas::drawGrabbedFrame (void)
+{
+  drawImage (m_grabbedFrame, true);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -57,6 +190,8 @@ void GLCanvas::draw (const graphics_handle& handle)
 
       r.set_viewport (width (), height ());
       r.draw(go);
+
+      m_frameDrawn = true;
     }
 }
 
@@ -33,6 +33,8 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+class RenderThread;
+
 class GLCanvas : public QGLWidget, public Canvas
 {
 public:
@@ -45,6 +47,8 @@ public:
 	       int /* width */, int /* height */) { }
   graphics_object selectFromAxes (const graphics_object& ax,
                                   const QPoint& pt);
+  bool grabFrame (void);
+  void drawGrabbedFrame (void);
   QWidget* qWidget (void) { return this; }
 
 protected:
@@ -54,6 +58,17 @@ protected:
   void mouseReleaseEvent (QMouseEvent* event);
   void keyPressEvent (QKeyEvent* event);
   void keyReleaseEvent (QKeyEvent* event);
+
+  bool requestFrame (void);
+  bool drawFrame (void);
+
+private:
+  void drawImage (const QImage& img, bool fit);
+
+private:
+  RenderThread* m_renderThread;
+  bool m_frameDrawn;
+  QImage m_grabbedFrame;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -22,9 +22,11 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef __GenericEventNotify_h__
 #define __GenericEventNotify_h__ 1
 
-#include <QSet>
+#include <QEvent>
+#include <QVector>
+
+#include <bitset>
 
-class QEvent;
 class QObject;
 class QWidget;
 
@@ -37,24 +39,34 @@ namespace QtHandles
 
 class GenericEventNotifyReceiver;
 
+// Receivers subscribe to specific event types (built-in types only, below
+// QEvent::User); other events go straight to the base class.
+
 class GenericEventNotifySender
 {
 public:
-  GenericEventNotifySender (void) : m_receivers () { }
+  GenericEventNotifySender (void) : m_subscriptions (), m_eventMask () { }
   virtual ~GenericEventNotifySender (void) { }
 
-  void addReceiver (GenericEventNotifyReceiver* r)
-    { m_receivers.insert (r); }
-
-  void removeReceiver (GenericEventNotifyReceiver* r)
-    { m_receivers.remove (r); }
+  void addReceiver (GenericEventNotifyReceiver* r, QEvent::Type type);
+  void removeReceiver (GenericEventNotifyReceiver* r);
 
 protected:
+  bool isNotified (QEvent::Type type) const
+    { return (type < QEvent::User && m_eventMask.test (type)); }
+
   bool notifyReceiversBefore (QObject* obj, QEvent* evt);
   void notifyReceiversAfter (QObject* obj, QEvent* evt);
 
 private:
-  QSet<GenericEventNotifyReceiver*> m_receivers;
+  struct Subscription
+  {
+    GenericEventNotifyReceiver* m_receiver;
+    QEvent::Type m_type;
+  };
+
+  QVector<Subscription> m_subscriptions;
+  std::bitset<QEvent::User> m_eventMask;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -71,12 +83,58 @@ public:
 
 //////////////////////////////////////////////////////////////////////////////
 
+inline
+void GenericEventNotifySender::addReceiver (GenericEventNotifyReceiver* r,
+                                            QEvent::Type type)
+{
+  if (type >= QEvent::User)
+    return;
+
+  foreach (const Subscription& s, m_subscriptions)
+    if (s.m_receiver == r && s.m_type == type)
+      return;
+
+  Subscription s;
+
+  s.m_receiver = r;
+  s.m_type = type;
+
+  m_subscriptions.append (s);
+  m_eventMask.set (type);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+inline
+void GenericEventNotifySender::removeReceiver (GenericEventNotifyReceiver* r)
+{
+  QVector<Subscription> subscriptions;
+
+  m_eventMask.reset ();
+
+  foreach (const Subscription& s, m_subscriptions)
+    if (s.m_receiver != r)
+      {
+        subscriptions.append (s);
+        m_eventMask.set (s.m_type);
+      }
+
+  m_subscriptions = subscriptions;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 inline
 bool GenericEventNotifySender::notifyReceiversBefore (QObject* obj,
                                                       QEvent* evt)
 {
-  foreach (GenericEventNotifyReceiver* r, m_receivers)
-    if (r->eventNotifyBefore (obj, evt))
+  // Shallow copy, receivers may unsubscribe while being notified.
+  const QVector<Subscription> subscriptions = m_subscriptions;
+  const Subscription* s = subscriptions.constData ();
+  QEvent::Type type = evt->type ();
+
+  for (int i = 0; i < subscriptions.size (); i++)
+    if (s[i].m_type == type && s[i].m_receiver->eventNotifyBefore (obj, evt))
       return true;
   return false;
 }
@@ -87,8 +145,13 @@ inline
 void GenericEventNotifySender::notifyReceiversAfter (QObject* obj,
                                                      QEvent* evt)
 {
-  foreach (GenericEventNotifyReceiver* r, m_receivers)
-    r->eventNotifyAfter (obj, evt);
+  const QVector<Subscription> subscriptions = m_subscriptions;
+  const Subscription* s = subscriptions.constData ();
+  QEvent::Type type = evt->type ();
+
+  for (int i = 0; i < subscriptions.size (); i++)
+    if (s[i].m_type == type)
+      s[i].m_receiver->eventNotifyAfter (obj, evt);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -102,6 +165,8 @@ public: \
 \
   bool event (QEvent* evt) \
     { \
+      if (! isNotified (evt->type ())) \
+        return B::event (evt); \
       bool result = true; \
       if (! notifyReceiversBefore (this, evt)) \
         result = B::event (evt); \
@@ -0,0 +1,135 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <QApplication>
+#include <QCryptographicHash>
+#include <QImage>
+#include <QPixmap>
+#include <QThread>
+
+#include "IconCache.h"
+#include "Utils.h"
+
+// Cache budget, in bytes of (32-bit) pixmap data.
+#define ICON_CACHE_BUDGET (4 * 1024 * 1024)
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+IconCache::IconCache (void)
+  : QObject (), m_icons (ICON_CACHE_BUDGET)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+IconCache* IconCache::instance (void)
+{
+  static IconCache s_instance;
+  static bool s_instanceCreated = false;
+
+  if (! s_instanceCreated)
+    {
+      if (QThread::currentThread () != QApplication::instance ()->thread ())
+	s_instance.moveToThread (QApplication::instance ()->thread ());
+      s_instanceCreated = true;
+    }
+
+  return &s_instance;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+static void addArrayData (QCryptographicHash& hash, const T& a)
+{
+  hash.addData (reinterpret_cast<const char*> (a.data ()),
+		a.numel () * sizeof (*a.data ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+QByteArray IconCache::key (const octave_value& cdata, int width, int height,
+			   const Matrix& cmap)
+{
+  QCryptographicHash hash (QCryptographicHash::Md5);
+  dim_vector dv (cdata.dims ());
+  QByteArray header;
+
+  // Data type, dimensions and icon size, then the raw values.
+  header.append (cdata.class_name ().c_str ());
+  for (int i = 0; i < dv.length (); i++)
+    header.append (QByteArray::number (qlonglong (dv(i))) + 'x');
+  header.append (QByteArray::number (width) + 'x'
+		 + QByteArray::number (height));
+  hash.addData (header);
+
+  if (cdata.is_uint8_type ())
+    addArrayData (hash, cdata.uint8_array_value ());
+  else if (cdata.is_single_type ())
+    addArrayData (hash, cdata.float_array_value ());
+  else if (cdata.is_real_type ())
+    addArrayData (hash, cdata.array_value ());
+
+  if (dv.length () == 2)
+    addArrayData (hash, cmap);
+
+  return hash.result ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+QIcon IconCache::icon (const octave_value& cdata, int width, int height,
+		       const Matrix& cmap)
+{
+  QCache<QByteArray, QIcon>& icons = instance ()->m_icons;
+  QByteArray k = key (cdata, width, height, cmap);
+  QIcon* cached = icons.object (k);
+
+  if (cached)
+    return *cached;
+
+  QImage img = Utils::makeImageFromCData (cdata, width, height, cmap);
+  QIcon result;
+
+  if (! img.isNull ())
+    result = QIcon (QPixmap::fromImage (img));
+
+  icons.insert (k, new QIcon (result),
+		qMax (1, img.width () * img.height () * 4));
+
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void IconCache::clear (void)
+{
+  m_icons.clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
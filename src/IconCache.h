@@ -0,0 +1,74 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __QtHandles_IconCache__
+#define __QtHandles_IconCache__ 1
+
+#include <QByteArray>
+#include <QCache>
+#include <QIcon>
+#include <QObject>
+
+#include <octave/oct.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Process-wide cache of icons built from CData, keyed by a hash of the
+// CData contents (and colormap, for indexed data) and the icon size, so
+// that identical icons used by many toolbars are converted and stored
+// only once. The least recently used icons are dropped once the pixmaps
+// exceed the cache budget. Must only be used from the GUI thread.
+
+class IconCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  static IconCache* instance (void);
+
+  static QIcon icon (const octave_value& cdata, int width, int height,
+		     const Matrix& cmap = Matrix ());
+
+public slots:
+  void clear (void);
+
+private:
+  IconCache (void);
+
+  static QByteArray key (const octave_value& cdata, int width, int height,
+			 const Matrix& cmap);
+
+private:
+  QCache<QByteArray, QIcon> m_icons;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -19,10 +19,18 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 */
 
-#include <QListWidget>
+#include <QItemSelectionModel>
+#include <QListView>
+#include <QPair>
+#include <QVector>
+#include <QtAlgorithms>
+
+#include <algorithm>
 
 #include "Container.h"
+#include "EventWakeup.h"
 #include "ListBoxControl.h"
+#include "StringVectorModel.h"
 #include "Utils.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -32,31 +40,67 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
-static void updateSelection (QListWidget* list, const Matrix& value)
+// Merges sorted, unique rows into contiguous selection ranges.
+
+static QItemSelection rowsToSelection (const QAbstractItemModel* model,
+				       const QVector<int>& rows)
 {
-  octave_idx_type n = value.numel ();
-  int lc = list->count ();
+  QItemSelection selection;
+  int n = rows.size ();
+
+  for (int i = 0; i < n; )
+    {
+      int j = i;
 
-  list->clearSelection ();
+      while (j+1 < n && rows[j+1] == rows[j] + 1)
+	j++;
 
+      selection.append (QItemSelectionRange (model->index (rows[i], 0),
+					     model->index (rows[j], 0)));
+      i = j+1;
+    }
+
+  return selection;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Applies the (1-based) indices in value as a single selection change. Any
+// out-of-range index results in an empty selection.
+
+static void updateSelection (QListView* list, const Matrix& value)
+{
+  octave_idx_type n = value.numel ();
+  QAbstractItemModel* model = list->model ();
+  int lc = model->rowCount ();
+  bool single = (list->selectionMode ()
+		 == QAbstractItemView::SingleSelection);
+  QVector<int> rows;
+
+  rows.reserve (single ? 1 : n);
   for (octave_idx_type i = 0; i < n; i++)
     {
       int idx = xround (value(i));
 
       if (1 <= idx && idx <= lc)
-        {
-          list->item (idx-1)->setSelected (true);
-          if (i == 0
-              && list->selectionMode () == QAbstractItemView::SingleSelection)
-            break;
-        }
+	{
+	  rows.append (idx-1);
+	  if (single)
+	    break;
+	}
       else
-        {
-          // Invalid selection.
-          list->clearSelection ();
-          break;
-        }
+	{
+	  // Invalid selection.
+	  rows.clear ();
+	  break;
+	}
     }
+
+  qSort (rows);
+  rows.erase (std::unique (rows.begin (), rows.end ()), rows.end ());
+
+  list->selectionModel ()->select (rowsToSelection (model, rows),
+				   QItemSelectionModel::ClearAndSelect);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -70,7 +114,7 @@ ListBoxControl* ListBoxControl::create (const graphics_object& go)
       Container* container = parent->innerContainer ();
 
       if (container)
-	return new ListBoxControl (go, new QListWidget (container));
+	return new ListBoxControl (go, new QListView (container));
     }
 
   return 0;
@@ -78,41 +122,30 @@ ListBoxControl* ListBoxControl::create (const graphics_object& go)
 
 //////////////////////////////////////////////////////////////////////////////
 
-ListBoxControl::ListBoxControl (const graphics_object& go, QListWidget* list)
-     : BaseControl (go, list), m_blockCallback (false)
+ListBoxControl::ListBoxControl (const graphics_object& go, QListView* list)
+     : BaseControl (go, list), m_blockCallback (false), m_model (0)
 {
   uicontrol::properties& up = properties<uicontrol> ();
 
-  list->addItems (Utils::fromStringVector (up.get_string_vector ()));
+  // Rows all have the same height and are only converted to text when
+  // visible, so that very long lists are cheap to display.
+  m_model = new StringVectorModel (list);
+  m_model->setStrings (up.get_string_vector ());
+  list->setUniformItemSizes (true);
+  list->setModel (m_model);
+
   if ((up.get_max () - up.get_min ()) > 1)
     list->setSelectionMode (QAbstractItemView::ExtendedSelection);
   else
     list->setSelectionMode (QAbstractItemView::SingleSelection);
-  Matrix value = up.get_value ().matrix_value ();
-  if (value.numel () > 0)
-    {
-      octave_idx_type n = value.numel ();
-      int lc = list->count ();
-
-      for (octave_idx_type i = 0; i < n; i++)
-	{
-	  int idx = xround (value(i));
-
-	  if (1 <= idx && idx <= lc)
-	    {
-	      list->item (idx-1)->setSelected (true);
-	      if (i == 0
-		  && list->selectionMode () ==
-		  	QAbstractItemView::SingleSelection)
-		break;
-	    }
-	}
-    }
+  updateSelection (list, up.get_value ().matrix_value ());
 
   list->removeEventFilter (this);
   list->viewport ()->installEventFilter (this);
 
-  connect (list, SIGNAL (itemSelectionChanged (void)),
+  connect (list->selectionModel (),
+	   SIGNAL (selectionChanged (const QItemSelection&,
+				     const QItemSelection&)),
 	   SLOT (itemSelectionChanged (void)));
 }
 
@@ -127,14 +160,13 @@ ListBoxControl::~ListBoxControl (void)
 void ListBoxControl::update (int pId)
 {
   uicontrol::properties& up = properties<uicontrol> ();
-  QListWidget* list = qWidget<QListWidget> ();
+  QListView* list = qWidget<QListView> ();
 
   switch (pId)
     {
     case uicontrol::properties::ID_STRING:
       m_blockCallback = true;
-      list->clear ();
-      list->addItems (Utils::fromStringVector (up.get_string_vector ()));
+      m_model->setStrings (up.get_string_vector ());
       updateSelection (list, up.get_value ().matrix_value ());
       m_blockCallback = false;
       break;
@@ -162,17 +194,38 @@ void ListBoxControl::itemSelectionChanged (void)
 {
   if (! m_blockCallback)
     {
-      QListWidget* list = qWidget<QListWidget> ();
+      QListView* list = qWidget<QListView> ();
+
+      // Read the selection back as ranges, rather than one index at a
+      // time, and return it in ascending order.
+      QItemSelection selection = list->selectionModel ()->selection ();
+      QVector<QPair<int, int> > ranges;
+      int count = 0;
+
+      ranges.reserve (selection.size ());
+      foreach (const QItemSelectionRange& r, selection)
+	ranges.append (qMakePair (r.top (), r.bottom ()));
+      qSort (ranges);
+
+      for (int k = 0, last = -1; k < ranges.size (); k++)
+	{
+	  ranges[k].first = qMax (ranges[k].first, last + 1);
+	  if (ranges[k].first <= ranges[k].second)
+	    {
+	      count += ranges[k].second - ranges[k].first + 1;
+	      last = ranges[k].second;
+	    }
+	}
 
-      QModelIndexList l = list->selectionModel ()->selectedIndexes ();
-      Matrix value (dim_vector (1, l.size ()));
+      Matrix value (dim_vector (1, count));
       int i = 0;
 
-      foreach (const QModelIndex& idx, l)
-       value(i++) = (idx.row () + 1);
+      for (int k = 0; k < ranges.size (); k++)
+	for (int row = ranges[k].first; row <= ranges[k].second; row++)
+	  value(i++) = (row + 1);
 
-      gh_manager::post_set (m_handle, "value", octave_value (value), false);
-      gh_manager::post_callback (m_handle, "callback");
+      EventWakeup::postSet (m_handle, "value", octave_value (value), false);
+      EventWakeup::postCallback (m_handle, "callback");
     }
 }
 
@@ -24,7 +24,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "BaseControl.h"
 
-class QListWidget;
+class QListView;
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -33,12 +33,14 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+class StringVectorModel;
+
 class ListBoxControl : public BaseControl
 {
   Q_OBJECT
 
 public:
-  ListBoxControl (const graphics_object& go, QListWidget* list);
+  ListBoxControl (const graphics_object& go, QListView* list);
   ~ListBoxControl (void);
 
   static ListBoxControl* create (const graphics_object& go);
@@ -51,6 +53,7 @@ private slots:
 
 private:
   bool m_blockCallback;
+  StringVectorModel* m_model;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMenu>
 #include <QMenuBar>
 
+#include "EventWakeup.h"
 #include "Figure.h"
 #include "Menu.h"
 #include "Utils.h"
@@ -274,14 +275,14 @@ void Menu::actionTriggered (void)
 
   if (action->isCheckable ())
     action->setChecked (! action->isChecked ());
-  gh_manager::post_callback (m_handle, "callback");
+  EventWakeup::postCallback (m_handle, "callback");
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void Menu::actionHovered (void)
 {
-  gh_manager::post_callback (m_handle, "callback");
+  EventWakeup::postCallback (m_handle, "callback");
 }
 
 //////////////////////////////////////////////////////////////////////////////
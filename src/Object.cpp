@@ -19,7 +19,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 */
 
-#include <QVariant>
+#include <QHash>
 
 #include "Backend.h"
 #include "Object.h"
@@ -32,8 +32,15 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Toolkit object associated with each QObject, see fromQObject. Only
+// accessed from the GUI thread.
+static QHash<QObject*, Object*> s_objects;
+
+//////////////////////////////////////////////////////////////////////////////
+
 Object::Object (const graphics_object& go, QObject* obj)
-  : QObject (), m_handle (go.get_handle ()), m_qobject (0)
+  : QObject (), m_handle (go.get_handle ()), m_qobject (0),
+    m_released (false)
 {
   gh_manager::auto_lock lock (false);
 
@@ -57,8 +64,7 @@ void Object::init (QObject* obj, bool)
 
   if (m_qobject)
     {
-      m_qobject->setProperty ("QtHandles::Object",
-			      qVariantFromValue<void*> (this));
+      s_objects.insert (m_qobject, this);
       connect (m_qobject, SIGNAL (destroyed (QObject*)),
 	       SLOT (objectDestroyed (QObject*)));
     }
@@ -68,6 +74,8 @@ void Object::init (QObject* obj, bool)
 
 Object::~Object (void)
 {
+  if (m_qobject && s_objects.value (m_qobject) == this)
+    s_objects.remove (m_qobject);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -116,6 +124,18 @@ void Object::slotFinalize (void)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Object::slotRelease (void)
+{
+  // The underlying QObject is owned by an ancestor that is being deleted,
+  // we'll delete ourselves when it gets destroyed.
+  m_released = true;
+
+  if (! m_qobject)
+    deleteLater ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Object::slotRedraw (void)
 {
   gh_manager::auto_lock lock;
@@ -159,7 +179,15 @@ void Object::beingDeleted (void)
 void Object::objectDestroyed (QObject* obj)
 {
   if (obj && obj == m_qobject)
-    m_qobject = 0;
+    {
+      if (s_objects.value (obj) == this)
+	s_objects.remove (obj);
+
+      m_qobject = 0;
+
+      if (m_released)
+	deleteLater ();
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -176,12 +204,7 @@ Object* Object::parentObject (const graphics_object& go)
 
 Object* Object::fromQObject (QObject* obj)
 {
-  QVariant v = obj->property ("QtHandles::Object");
-
-  if (v.isValid ())
-    return reinterpret_cast<Object*> (qVariantValue<void*> (v));
-
-  return 0;
+  return s_objects.value (obj, 0);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -83,6 +83,7 @@ public:
 public slots:
   void slotUpdate (int pId);
   void slotFinalize (void);
+  void slotRelease (void);
   void slotRedraw (void);
 
   void objectDestroyed (QObject *obj = 0);
@@ -100,6 +101,7 @@ protected:
 protected:
   graphics_handle m_handle;
   QObject* m_qobject;
+  bool m_released;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -54,6 +54,27 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+static bool isShown (const graphics_object& go)
+{
+  // Figures, panels and controls are only created when they are visible,
+  // including all their ancestors.
+
+  graphics_object obj (go);
+
+  while (obj.valid_object ())
+    {
+      if ((obj.isa ("figure") || obj.isa ("uipanel") || obj.isa ("uicontrol"))
+	  && ! obj.get_properties ().is_visible ())
+	return false;
+
+      obj = gh_manager::get_object (obj.get_parent ());
+    }
+
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 ObjectFactory* ObjectFactory::instance (void)
 {
   static ObjectFactory s_instance;
@@ -85,7 +106,19 @@ void ObjectFactory::createObject (double handle)
 	{
 	  ObjectProxy* proxy = Backend::toolkitObjectProxy (go);
 
-	  if (proxy)
+	  if (proxy && proxy->object ())
+	    {
+	      // Already created, either along with an ancestor that just
+	      // became visible, or the object itself became visible again:
+	      // create any descendants deferred while it was hidden.
+	      if (isShown (go))
+		createChildren (go);
+	    }
+	  else if (proxy && ! isShown (go))
+	    Logger::debug ("ObjectFactory::createObject: "
+			   "deferring creation of hidden %s",
+			   go.type ().c_str ());
+	  else if (proxy)
 	    {
 	      Logger::debug ("ObjectFactory::createObject: "
 			     "create %s from thread %08x",
@@ -136,7 +169,10 @@ void ObjectFactory::createObject (double handle)
 			  go.type ().c_str ());
 
 	      if (obj)
-		proxy->setObject (obj);
+		{
+		  proxy->setObject (obj);
+		  createChildren (go);
+		}
 	    }
 	  else
 	    qWarning ("ObjectFactory::createObject: no proxy for handle %g",
@@ -150,4 +186,24 @@ void ObjectFactory::createObject (double handle)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void ObjectFactory::createChildren (const graphics_object& go)
+{
+  // Create the children whose creation has been deferred because they
+  // were hidden. Children are stored from top to bottom, create them in
+  // reverse order to preserve the stacking order.
+
+  Matrix kids = go.get_properties ().get_all_children ();
+
+  for (octave_idx_type i = kids.numel () - 1; i >= 0; i--)
+    {
+      graphics_object kid (gh_manager::get_object (kids(i)));
+
+      if (kid.valid_object () && ! kid.isa ("axes")
+	  && Backend::toolkitObjectProxy (kid))
+	createObject (kids(i));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 };
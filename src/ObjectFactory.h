@@ -45,6 +45,9 @@ public:
 public slots:
   void createObject (double handle);
 
+private:
+  void createChildren (const graphics_object& go);
+
 private:
   ObjectFactory (void)
     : QObject ()
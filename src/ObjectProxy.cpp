@@ -19,6 +19,9 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 */
 
+#include <QCoreApplication>
+#include <QEvent>
+
 #include <octave/config.h>
 #include <octave/oct-mutex.h>
 
@@ -50,6 +53,8 @@ void ObjectProxy::init (Object* obj)
 		      m_object, SLOT (slotUpdate (int)));
 	  disconnect (this, SIGNAL (sendFinalize (void)),
 		      m_object, SLOT (slotFinalize (void)));
+	  disconnect (this, SIGNAL (sendRelease (void)),
+		      m_object, SLOT (slotRelease (void)));
 	  disconnect (this, SIGNAL (sendRedraw (void)),
 		      m_object, SLOT (slotRedraw (void)));
 	}
@@ -62,6 +67,8 @@ void ObjectProxy::init (Object* obj)
 		   m_object, SLOT (slotUpdate (int)));
 	  connect (this, SIGNAL (sendFinalize (void)),
 		   m_object, SLOT (slotFinalize (void)));
+	  connect (this, SIGNAL (sendRelease (void)),
+		   m_object, SLOT (slotRelease (void)));
 	  connect (this, SIGNAL (sendRedraw (void)),
 		   m_object, SLOT (slotRedraw (void)));
 	}
@@ -82,7 +89,7 @@ void ObjectProxy::update (int pId)
 {
   if (octave_thread::is_octave_thread ())
     emit sendUpdate (pId);
-  else
+  else if (m_object)
     m_object->slotUpdate (pId);
 }
 
@@ -96,6 +103,19 @@ void ObjectProxy::finalize (void)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void ObjectProxy::release (void)
+{
+  // Drop any pending update for the object, it is going to be destroyed
+  // with its ancestor anyway.
+  if (m_object)
+    QCoreApplication::removePostedEvents (m_object, QEvent::MetaCall);
+
+  emit sendRelease ();
+  init (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void ObjectProxy::redraw (void)
 {
   emit sendRedraw ();
@@ -42,6 +42,7 @@ public:
 
    void update (int pId);
    void finalize (void);
+   void release (void);
    void redraw (void);
 
    Object* object (void) { return m_object; }
@@ -50,6 +51,7 @@ public:
 signals:
    void sendUpdate (int pId);
    void sendFinalize (void);
+   void sendRelease (void);
    void sendRedraw (void);
 
 private:
@@ -25,9 +25,11 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMouseEvent>
 #include <QTimer>
 
+#include "Backend.h"
 #include "Canvas.h"
 #include "Container.h"
 #include "ContextMenu.h"
+#include "Figure.h"
 #include "Panel.h"
 #include "Utils.h"
 
@@ -86,6 +88,33 @@ static int borderWidthFromProperties (const uipanel::properties& pp)
 
 //////////////////////////////////////////////////////////////////////////////
 
+static bool hasAxesChildren (const base_properties& props)
+{
+  Matrix kids = props.get_all_children ();
+
+  for (octave_idx_type i = 0; i < kids.numel (); i++)
+    {
+      graphics_object go (gh_manager::get_object (kids(i)));
+
+      if (go && go.isa ("axes"))
+	return true;
+    }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void updateParentLayout (const uipanel::properties& pp, QFrame* frame)
+{
+  Container* container = dynamic_cast<Container*> (frame->parentWidget ());
+
+  if (container)
+    container->setChildLayout (frame, pp);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 Panel* Panel::create (const graphics_object& go)
 {
   Object* parent = Object::parentObject (go);
@@ -113,14 +142,15 @@ Panel::Panel (const graphics_object& go, QFrame* frame)
   Matrix bb = pp.get_boundingbox (false);
   frame->setGeometry (xround (bb(0)), xround (bb(1)),
 		      xround (bb(2)), xround (bb(3)));
+  updateParentLayout (pp, frame);
   frame->setFrameStyle (frameStyleFromProperties (pp));
   frame->setLineWidth (xround (pp.get_borderwidth ()));
   QPalette pal = frame->palette ();
   setupPalette (pp, pal);
   frame->setPalette (pal);
 
+  // The canvas is only created when the panel gets axes, see redraw.
   m_container = new Container (frame);
-  m_container->canvas (m_handle);
 
   QString title = Utils::fromStdString (pp.get_title ());
   if (! title.isEmpty ())
@@ -135,6 +165,11 @@ Panel::Panel (const graphics_object& go, QFrame* frame)
   frame->installEventFilter (this);
   m_container->installEventFilter (this);
 
+  m_figure = dynamic_cast<Figure*> (Backend::toolkitObject
+				    (go.get_ancestor ("figure")));
+  if (m_figure)
+    m_figure->addPanel (this);
+
   if (pp.is_visible ())
     QTimer::singleShot (0, frame, SLOT (show (void)));
   else
@@ -203,7 +238,10 @@ bool Panel::eventFilter (QObject* watched, QEvent* event)
 	  switch (event->type ())
 	    {
 	    case QEvent::Resize:
-	      if (qWidget<QWidget> ()->isVisible ())
+	      // During an interactive resize, the figure updates all
+	      // panels once the resize ends.
+	      if (qWidget<QWidget> ()->isVisible ()
+		  && ! (m_figure && m_figure->isResizing ()))
 		{
 		  gh_manager::auto_lock lock;
 
@@ -236,9 +274,13 @@ void Panel::update (int pId)
 
 	  frame->setGeometry (xround (bb(0)), xround (bb(1)),
 			      xround (bb(2)), xround (bb(3)));
+	  updateParentLayout (pp, frame);
 	  updateLayout ();
 	}
       break;
+    case uipanel::properties::ID_UNITS:
+      updateParentLayout (pp, frame);
+      break;
     case uipanel::properties::ID_BORDERWIDTH:
       frame->setLineWidth (xround (pp.get_borderwidth ()));
       updateLayout ();
@@ -318,9 +360,21 @@ void Panel::update (int pId)
 
 //////////////////////////////////////////////////////////////////////////////
 
+Canvas* Panel::canvas (void)
+{
+  return m_container->canvas (m_handle, false);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Panel::redraw (void)
 {
-  Canvas* canvas = m_container->canvas (m_handle);
+  Canvas* canvas = m_container->canvas (m_handle, false);
+
+  // The canvas is only created once the panel contains axes; the
+  // children are only scanned until then.
+  if (! canvas && hasAxesChildren (properties ()))
+    canvas = m_container->canvas (m_handle);
 
   if (canvas)
     canvas->redraw ();
@@ -22,6 +22,8 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef __QtHandles_Panel__
 #define __QtHandles_Panel__ 1
 
+#include <QPointer>
+
 #include "Object.h"
 
 class QFrame;
@@ -34,7 +36,9 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+class Canvas;
 class Container;
+class Figure;
 
 class Panel : public Object
 {
@@ -43,6 +47,7 @@ public:
   ~Panel (void);
 
   Container* innerContainer (void) { return m_container; }
+  Canvas* canvas (void);
 
   bool eventFilter (QObject* watched, QEvent* event);
 
@@ -59,6 +64,7 @@ private:
   Container* m_container;
   QLabel* m_title;
   bool m_blockUpdates;
+  QPointer<Figure> m_figure;
 };
 
 //////////////////////////////////////////////////////////////////////////////
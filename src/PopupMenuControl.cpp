@@ -20,9 +20,12 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <QComboBox>
+#include <QListView>
 
 #include "Container.h"
+#include "EventWakeup.h"
 #include "PopupMenuControl.h"
+#include "StringVectorModel.h"
 #include "Utils.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -32,6 +35,35 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Splits the "string" property into items, on '|' like the old
+// QString::split based code did.
+
+static string_vector popupItems (const std::string& s)
+{
+  octave_idx_type n = 1;
+
+  for (size_t pos = s.find ('|'); pos != std::string::npos;
+       pos = s.find ('|', pos + 1))
+    n++;
+
+  string_vector items (n);
+  size_t start = 0;
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      size_t end = s.find ('|', start);
+
+      if (end == std::string::npos)
+	end = s.length ();
+      items[i] = s.substr (start, end - start);
+      start = end + 1;
+    }
+
+  return items;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 PopupMenuControl* PopupMenuControl::create (const graphics_object& go)
 {
   Object* parent = Object::parentObject (go);
@@ -50,11 +82,22 @@ PopupMenuControl* PopupMenuControl::create (const graphics_object& go)
 //////////////////////////////////////////////////////////////////////////////
 
 PopupMenuControl::PopupMenuControl (const graphics_object& go, QComboBox *box)
-     : BaseControl (go, box), m_blockUpdate (false)
+     : BaseControl (go, box), m_blockUpdate (false), m_model (0)
 {
   uicontrol::properties& up = properties<uicontrol> ();
 
-  box->addItems (Utils::fromStdString (up.get_string_string ()).split ('|'));
+  // Items are kept as a string_vector and only converted for display.
+  // Don't let the combo box size itself by measuring every item, and let
+  // keyboard search go through the model's lower-cased index.
+  m_model = new StringVectorModel (box);
+  m_model->setStrings (popupItems (up.get_string_string ()));
+  box->setModel (m_model);
+  box->setSizeAdjustPolicy (QComboBox::AdjustToMinimumContentsLength);
+
+  QListView* view = qobject_cast<QListView*> (box->view ());
+
+  if (view)
+    view->setUniformItemSizes (true);
 
   connect (box, SIGNAL (currentIndexChanged (int)),
 	   SLOT (currentIndexChanged (int)));
@@ -80,9 +123,7 @@ void PopupMenuControl::update (int pId)
 	{
 	  int oldCurrent = box->currentIndex ();
 
-	  box->clear ();
-	  box->addItems (Utils::fromStdString
-			 (up.get_string_string ()).split ('|'));
+	  m_model->updateStrings (popupItems (up.get_string_string ()));
 	  if (box->count() > 0
 	      && oldCurrent >= 0
 	      && oldCurrent < box->count ())
@@ -91,7 +132,7 @@ void PopupMenuControl::update (int pId)
 	    }
 	  else
 	    {
-	      gh_manager::post_set (m_handle, "value",
+	      EventWakeup::postSet (m_handle, "value",
 				    octave_value (box->count () > 0
 						  ? 1.0 : 0.0),
 				    false);
@@ -127,10 +168,10 @@ void PopupMenuControl::currentIndexChanged (int index)
 {
   if (! m_blockUpdate)
     {
-      gh_manager::post_set (m_handle, "value",
+      EventWakeup::postSet (m_handle, "value",
 			    octave_value (double (index + 1)),
 			    false);
-      gh_manager::post_callback (m_handle, "callback");
+      EventWakeup::postCallback (m_handle, "callback");
     }
 }
 
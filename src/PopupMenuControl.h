@@ -33,6 +33,8 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+class StringVectorModel;
+
 class PopupMenuControl : public BaseControl
 {
   Q_OBJECT
@@ -51,6 +53,7 @@ private slots:
 
 private:
   bool m_blockUpdate;
+  StringVectorModel* m_model;
 };
 
 //////////////////////////////////////////////////////////////////////////////
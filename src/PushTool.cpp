@@ -19,6 +19,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 */
 
+#include "EventWakeup.h"
 #include "PushTool.h"
 
 #include "ToolBarButton.cpp"
@@ -75,7 +76,7 @@ void PushTool::update (int pId)
 
 void PushTool::clicked (void)
 {
-  gh_manager::post_callback (m_handle, "clickedcallback");
+  EventWakeup::postCallback (m_handle, "clickedcallback");
 }
 
 //////////////////////////////////////////////////////////////////////////////
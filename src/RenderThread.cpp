@@ -0,0 +1,196 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <QGLPixelBuffer>
+#include <QGLWidget>
+#include <QMutexLocker>
+#include <QProcessEnvironment>
+
+#include <octave/oct.h>
+#include <octave/gl-render.h>
+#include <octave/graphics.h>
+
+#include "Logger.h"
+#include "RenderThread.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+RenderThread::RenderThread (QWidget* target)
+  : QThread (), m_target (target), m_handle (), m_size (),
+    m_requested (false), m_stopped (false), m_frame (), m_serial (0)
+{
+  connect (this, SIGNAL (finished (void)), SLOT (deleteLater (void)));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+RenderThread::~RenderThread (void)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool RenderThread::enabled (void)
+{
+  static int s_enabled = -1;
+
+  if (s_enabled < 0)
+    {
+      QProcessEnvironment pe (QProcessEnvironment::systemEnvironment ());
+
+      s_enabled = (pe.value ("QTHANDLES_RENDER_THREADS", "0") != "0"
+		   && QGLPixelBuffer::hasOpenGLPbuffers ());
+    }
+
+  return s_enabled;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void RenderThread::requestFrame (const graphics_handle& handle,
+				 const QSize& size)
+{
+  QMutexLocker lock (&m_mutex);
+
+  m_handle = handle;
+  m_size = size;
+  m_requested = true;
+
+  m_condition.wakeOne ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+int RenderThread::frame (QImage& img)
+{
+  QMutexLocker lock (&m_mutex);
+
+  img = m_frame;
+
+  return m_serial;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void RenderThread::stop (void)
+{
+  // Don't wait for the thread here: it may be waiting for the gh_manager
+  // lock held by the caller.
+
+  QMutexLocker lock (&m_mutex);
+
+  m_target = 0;
+  m_stopped = true;
+
+  m_condition.wakeOne ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void RenderThread::run (void)
+{
+  QGLPixelBuffer* pbuffer = 0;
+
+  forever
+    {
+      graphics_handle handle;
+      QSize size;
+
+	{
+	  QMutexLocker lock (&m_mutex);
+
+	  while (! m_requested && ! m_stopped)
+	    m_condition.wait (&m_mutex);
+
+	  if (m_stopped)
+	    break;
+
+	  handle = m_handle;
+	  size = m_size;
+	  m_requested = false;
+	}
+
+      if (size.isEmpty ())
+	continue;
+
+      if (! pbuffer || pbuffer->size () != size)
+	{
+	  delete pbuffer;
+	  pbuffer = new QGLPixelBuffer (size);
+
+	  if (! pbuffer->isValid ())
+	    {
+	      qWarning ("RenderThread::run: unable to create pixel buffer");
+	      delete pbuffer;
+	      pbuffer = 0;
+	      continue;
+	    }
+	}
+
+      pbuffer->makeCurrent ();
+
+      // The renderer reads the graphics objects while it issues the GL
+      // commands, so the lock is held for that part only. Rasterizing
+      // and reading the pixels back happen after it's released.
+	{
+	  gh_manager::auto_lock lock;
+
+	  graphics_object go = gh_manager::get_object (handle);
+
+	  if (go)
+	    {
+	      opengl_renderer r;
+
+	      r.set_viewport (size.width (), size.height ());
+	      r.draw (go);
+	    }
+	}
+
+      glFinish ();
+
+      // Convert here, the GUI thread only has to copy the pixels.
+      QImage img = QGLWidget::convertToGLFormat (pbuffer->toImage ());
+
+      pbuffer->doneCurrent ();
+
+      Logger::debug ("RenderThread::run: frame %dx%d ready",
+		     size.width (), size.height ());
+
+      QMutexLocker lock (&m_mutex);
+
+      m_frame = img;
+      m_serial++;
+
+      if (m_target)
+	QMetaObject::invokeMethod (m_target, "update", Qt::QueuedConnection);
+    }
+
+  delete pbuffer;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
@@ -0,0 +1,91 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __QtHandles_RenderThread__
+#define __QtHandles_RenderThread__ 1
+
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <octave/oct.h>
+#include <octave/graphics.h>
+
+class QWidget;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Renders a figure in its own thread and OpenGL context (a pixel buffer).
+// The GUI thread requests frames and composites the last finished one;
+// the target widget is asked to repaint whenever a new frame is ready.
+// Requests made while a frame is being rendered are merged.
+//
+// Enabled by setting QTHANDLES_RENDER_THREADS to a non-zero value.
+
+class RenderThread : public QThread
+{
+  Q_OBJECT
+
+public:
+  RenderThread (QWidget* target);
+
+  static bool enabled (void);
+
+  void requestFrame (const graphics_handle& handle, const QSize& size);
+
+  // Returns the serial number of the last frame, 0 if none is available.
+  int frame (QImage& img);
+
+  // Detach from the target widget; the thread deletes itself once done.
+  void stop (void);
+
+protected:
+  void run (void);
+
+private:
+  ~RenderThread (void);
+
+private:
+  QMutex m_mutex;
+  QWaitCondition m_condition;
+  QWidget* m_target;
+  graphics_handle m_handle;
+  QSize m_size;
+  bool m_requested;
+  bool m_stopped;
+  QImage m_frame;
+  int m_serial;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -19,9 +19,13 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 */
 
+#include <QProcessEnvironment>
 #include <QScrollBar>
+#include <QTimer>
 
 #include "Container.h"
+#include "EventCoalescer.h"
+#include "EventWakeup.h"
 #include "SliderControl.h"
 #include "Utils.h"
 
@@ -34,6 +38,33 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Minimum delay (in ms) between two values sent while the slider is being
+// dragged, or 0 if only the final value is sent. Set by the maximum rate
+// (in updates per second) given in QTHANDLES_SLIDER_RATE.
+//
+// This is a process-wide setting on purpose: uicontrol has no property
+// that could carry it, and a toolkit can't add properties of its own to
+// octave's graphics objects, so there is nothing per slider that a
+// script could set and the toolkit could read back.
+
+static int continuousInterval (void)
+{
+  static int s_interval = -1;
+
+  if (s_interval < 0)
+    {
+      QProcessEnvironment pe (QProcessEnvironment::systemEnvironment ());
+      bool ok;
+      double rate = pe.value ("QTHANDLES_SLIDER_RATE", "0").toDouble (&ok);
+
+      s_interval = (ok && rate > 0 ? qMax (1, qRound (1000 / rate)) : 0);
+    }
+
+  return s_interval;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 SliderControl* SliderControl::create (const graphics_object& go)
 {
   Object* parent = Object::parentObject (go);
@@ -53,11 +84,13 @@ SliderControl* SliderControl::create (const graphics_object& go)
 
 SliderControl::SliderControl (const graphics_object& go,
 			      QAbstractSlider* slider)
-    : BaseControl (go, slider), m_blockUpdates (false)
+    : BaseControl (go, slider), m_blockUpdates (false),
+      m_continuous (continuousInterval () > 0), m_lastPosted (-1),
+      m_lastPostTime (), m_rateTimer (0)
 {
   uicontrol::properties& up = properties<uicontrol> ();
 
-  slider->setTracking (false);
+  slider->setTracking (m_continuous);
   Matrix bb = up.get_boundingbox ();
   slider->setOrientation (bb(2) > bb(3) ? Qt::Horizontal : Qt::Vertical);
   Matrix steps = up.get_sliderstep ().matrix_value ();
@@ -74,7 +107,19 @@ SliderControl::SliderControl (const graphics_object& go,
 				* RANGE_INT_MAX));
     }
 
+  m_lastPosted = slider->value ();
+
   connect (slider, SIGNAL (valueChanged (int)), SLOT (valueChanged (int)));
+
+  if (m_continuous)
+    {
+      m_rateTimer = new QTimer (this);
+      m_rateTimer->setSingleShot (true);
+      connect (m_rateTimer, SIGNAL (timeout (void)),
+	       SLOT (postPendingValue (void)));
+      connect (slider, SIGNAL (sliderReleased (void)),
+	       SLOT (sliderReleased (void)));
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -105,13 +150,17 @@ void SliderControl::update (int pId)
 	  Matrix value = up.get_value ().matrix_value ();
 	  double dmax = up.get_max (), dmin = up.get_min ();
 
-	  if (value.numel () > 0)
+	  // Don't fight the user over a value octave is only now catching
+	  // up with.
+	  if (value.numel () > 0
+	      && ! (m_continuous && slider->isSliderDown ()))
 	    {
 	      int ival = xround (((value(0) - dmin) / (dmax - dmin))
 				 * RANGE_INT_MAX);
 
 	      m_blockUpdates = true;
 	      slider->setValue (ival);
+	      m_lastPosted = slider->value ();
 	      m_blockUpdates = false;
 	    }
 	}
@@ -124,34 +173,95 @@ void SliderControl::update (int pId)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void SliderControl::valueChanged (int ival)
+void SliderControl::postValue (int ival)
 {
-  if (! m_blockUpdates)
+  gh_manager::auto_lock lock;
+  graphics_object go = object ();
+
+  if (go.valid_object ())
     {
-      gh_manager::auto_lock lock;
-      graphics_object go = object ();
+      uicontrol::properties& up = Utils::properties<uicontrol> (go);
 
-      if (go.valid_object ())
-	{
-	  uicontrol::properties& up = Utils::properties<uicontrol> (go);
+      Matrix value = up.get_value ().matrix_value ();
+      double dmin = up.get_min (), dmax = up.get_max ();
 
-	  Matrix value = up.get_value ().matrix_value ();
-	  double dmin = up.get_min (), dmax = up.get_max ();
+      int ival_tmp = (value.numel () > 0 ?
+		      xround (((value(0) - dmin) / (dmax - dmin))
+			      * RANGE_INT_MAX) :
+		      0);
 
-	  int ival_tmp = (value.numel () > 0 ?
-			  xround (((value(0) - dmin) / (dmax - dmin))
-				  * RANGE_INT_MAX) :
-			  0);
+      if (ival != ival_tmp || value.numel () > 0)
+	{
+	  double dval = dmin + (ival * (dmax - dmin) / RANGE_INT_MAX);
 
-	  if (ival != ival_tmp || value.numel () > 0)
+	  if (m_continuous)
 	    {
-	      double dval = dmin + (ival * (dmax - dmin) / RANGE_INT_MAX);
-
-	      gh_manager::post_set (m_handle, "value", octave_value (dval));
-	      gh_manager::post_callback (m_handle, "callback");
+	      // Values that octave hasn't picked up yet are replaced by
+	      // newer ones; the last value posted is always delivered.
+	      // Like below, the toolkit isn't notified of the value it
+	      // already shows.
+	      EventCoalescer::post (m_handle, "value", octave_value (dval),
+				    "callback");
+	    }
+	  else
+	    {
+	      EventWakeup::postSet (m_handle, "value", octave_value (dval),
+				    false);
+	      EventWakeup::postCallback (m_handle, "callback");
 	    }
 	}
     }
+
+  m_lastPosted = ival;
+  m_lastPostTime.start ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SliderControl::valueChanged (int ival)
+{
+  if (! m_blockUpdates)
+    {
+      QAbstractSlider* slider = qWidget<QAbstractSlider> ();
+
+      if (m_continuous && slider->isSliderDown ())
+	{
+	  int wait = (m_lastPostTime.isValid ()
+		      ? continuousInterval () - m_lastPostTime.elapsed ()
+		      : 0);
+
+	  if (wait <= 0)
+	    postValue (ival);
+	  else if (! m_rateTimer->isActive ())
+	    m_rateTimer->start (wait);
+	}
+      else
+	{
+	  if (m_rateTimer)
+	    m_rateTimer->stop ();
+	  postValue (ival);
+	}
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SliderControl::sliderReleased (void)
+{
+  // With tracking enabled, releasing the slider doesn't change its value;
+  // make sure the final position is sent even if it was throttled.
+  m_rateTimer->stop ();
+  postPendingValue ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SliderControl::postPendingValue (void)
+{
+  int ival = qWidget<QAbstractSlider> ()->value ();
+
+  if (ival != m_lastPosted)
+    postValue (ival);
 }
 
 //////////////////////////////////////////////////////////////////////////////
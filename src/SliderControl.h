@@ -22,9 +22,12 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef __QtHandles_SliderControl__
 #define __QtHandles_SliderControl__ 1
 
+#include <QElapsedTimer>
+
 #include "BaseControl.h"
 
 class QAbstractSlider;
+class QTimer;
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -46,11 +49,23 @@ public:
 protected:
   void update (int pId);
 
+private:
+  void postValue (int ival);
+
 private slots:
   void valueChanged (int ival);
+  void sliderReleased (void);
+  void postPendingValue (void);
 
 private:
   bool m_blockUpdates;
+
+  // Continuous mode: values are also sent while dragging, at most once
+  // per interval (see QTHANDLES_SLIDER_RATE).
+  bool m_continuous;
+  int m_lastPosted;
+  QElapsedTimer m_lastPostTime;
+  QTimer* m_rateTimer;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,187 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "StringVectorModel.h"
+#include "Utils.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+StringVectorModel::StringVectorModel (QObject* parent)
+  : QAbstractListModel (parent), m_strings ()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+StringVectorModel::~StringVectorModel (void)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StringVectorModel::setStrings (const string_vector& strings)
+{
+  beginResetModel ();
+  m_strings = strings;
+  m_lowerIndex.clear ();
+  endResetModel ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Like setStrings, but only notifies views about the span of rows that
+// actually differs (after skipping the common head and tail), so that
+// selections and the current row outside of it are preserved.
+
+void StringVectorModel::updateStrings (const string_vector& strings)
+{
+  // Compare through a const reference: the non-const operator[] would
+  // make a private copy of the (shared) strings.
+  const string_vector& oldStrings = m_strings;
+  int oldCount = oldStrings.length ();
+  int newCount = strings.length ();
+  int head = 0, tail = 0;
+
+  while (head < oldCount && head < newCount
+	 && oldStrings[head] == strings[head])
+    head++;
+
+  while (tail < oldCount - head && tail < newCount - head
+	 && oldStrings[oldCount-1-tail] == strings[newCount-1-tail])
+    tail++;
+
+  int oldSpan = oldCount - head - tail;
+  int newSpan = newCount - head - tail;
+  int common = qMin (oldSpan, newSpan);
+
+  if (newSpan < oldSpan)
+    {
+      beginRemoveRows (QModelIndex (), head + common, head + oldSpan - 1);
+      m_strings = strings;
+      m_lowerIndex.clear ();
+      endRemoveRows ();
+    }
+  else if (newSpan > oldSpan)
+    {
+      beginInsertRows (QModelIndex (), head + common, head + newSpan - 1);
+      m_strings = strings;
+      m_lowerIndex.clear ();
+      endInsertRows ();
+    }
+  else
+    {
+      m_strings = strings;
+      if (common > 0)
+	m_lowerIndex.clear ();
+    }
+
+  if (common > 0)
+    emit dataChanged (index (head), index (head + common - 1));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+int StringVectorModel::rowCount (const QModelIndex& parent) const
+{
+  if (parent.isValid ())
+    return 0;
+
+  return m_strings.length ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+QVariant StringVectorModel::data (const QModelIndex& index, int role) const
+{
+  if (index.isValid () && index.row () < m_strings.length ()
+      && (role == Qt::DisplayRole || role == Qt::EditRole))
+    return Utils::fromStdString (m_strings[index.row ()]);
+
+  return QVariant ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Case-insensitive prefix/substring/full matches (as used by the views'
+// keyboard search) are answered from the lower-cased index; everything
+// else is left to the generic implementation.
+
+QModelIndexList StringVectorModel::match (const QModelIndex& start, int role,
+					  const QVariant& value, int hits,
+					  Qt::MatchFlags flags) const
+{
+  int matchType = (flags & 0x0F);
+
+  if ((role != Qt::DisplayRole && role != Qt::EditRole)
+      || (flags & (Qt::MatchCaseSensitive | Qt::MatchRecursive))
+      || (matchType != Qt::MatchStartsWith
+	  && matchType != Qt::MatchContains
+	  && matchType != Qt::MatchFixedString))
+    return QAbstractListModel::match (start, role, value, hits, flags);
+
+  int n = m_strings.length ();
+
+  if (m_lowerIndex.size () != n)
+    {
+      m_lowerIndex.resize (n);
+      for (int i = 0; i < n; i++)
+	m_lowerIndex[i] = Utils::fromStdString (m_strings[i]).toLower ();
+    }
+
+  QString key = value.toString ().toLower ();
+  QModelIndexList result;
+  int from = (start.isValid () ? start.row () : 0);
+  int count = ((flags & Qt::MatchWrap) ? n : n - from);
+
+  for (int k = 0; k < count && (hits < 0 || result.size () < hits); k++)
+    {
+      int row = (from + k) % n;
+      const QString& str = m_lowerIndex[row];
+      bool found;
+
+      switch (matchType)
+	{
+	case Qt::MatchStartsWith:
+	  found = str.startsWith (key);
+	  break;
+	case Qt::MatchContains:
+	  found = str.contains (key);
+	  break;
+	default:
+	  found = (str == key);
+	  break;
+	}
+
+      if (found)
+	result.append (index (row));
+    }
+
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
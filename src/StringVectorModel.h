@@ -0,0 +1,77 @@
+/*
+
+Copyright (C) 2011 Michael Goffioul.
+
+This file is part of QtHandles.
+
+Foobar is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+QtHandles is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __QtHandles_StringVectorModel__
+#define __QtHandles_StringVectorModel__ 1
+
+#include <QAbstractListModel>
+#include <QVector>
+
+#include <octave/oct.h>
+#include <octave/str-vec.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace QtHandles
+{
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Read-only list model over a string_vector. The strings are shared with
+// octave (string_vector is reference counted) and only converted to
+// QString when a view asks for them, i.e. for the visible rows.
+
+class StringVectorModel : public QAbstractListModel
+{
+  Q_OBJECT
+
+public:
+  StringVectorModel (QObject* parent = 0);
+  ~StringVectorModel (void);
+
+  const string_vector& strings (void) const { return m_strings; }
+  void setStrings (const string_vector& strings);
+  void updateStrings (const string_vector& strings);
+
+  int rowCount (const QModelIndex& parent = QModelIndex ()) const;
+  QVariant data (const QModelIndex& index, int role = Qt::DisplayRole) const;
+
+  QModelIndexList match (const QModelIndex& start, int role,
+			 const QVariant& value, int hits = 1,
+			 Qt::MatchFlags flags =
+			   Qt::MatchFlags (Qt::MatchStartsWith
+					   | Qt::MatchWrap)) const;
+
+private:
+  string_vector m_strings;
+
+  // Lower-cased copy of m_strings, built on the first case-insensitive
+  // search and dropped whenever the strings change.
+  mutable QVector<QString> m_lowerIndex;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+}; // namespace QtHandles
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -19,6 +19,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 
 */
 
+#include "EventWakeup.h"
 #include "ToggleTool.h"
 
 #include "ToolBarButton.cpp"
@@ -87,12 +88,12 @@ void ToggleTool::update (int pId)
 
 void ToggleTool::triggered (bool checked)
 {
-  gh_manager::post_set (m_handle, "state", checked, false);
-  gh_manager::post_callback (m_handle,
-			     checked
-			     ? "oncallback"
-			     : "offcallback");
-  gh_manager::post_callback (m_handle, "clickedcallback");
+  EventWakeup::postSet (m_handle, "state", checked, false);
+  EventWakeup::postCallback (m_handle,
+			      checked
+			      ? "oncallback"
+			      : "offcallback");
+  EventWakeup::postCallback (m_handle, "clickedcallback");
 }
 
 //////////////////////////////////////////////////////////////////////////////
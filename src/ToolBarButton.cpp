@@ -22,6 +22,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #include <QAction>
 #include <QWidget>
 
+#include "IconCache.h"
 #include "ToolBarButton.h"
 #include "Utils.h"
 
@@ -32,6 +33,26 @@ namespace QtHandles
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Icons are shared through the icon cache. Indexed CData uses the
+// colormap of the parent figure.
+
+static QIcon makeIcon (const graphics_object& go, const octave_value& cdata)
+{
+  Matrix cmap;
+
+  if (cdata.ndims () == 2)
+    {
+      graphics_object fig = go.get_ancestor ("figure");
+
+      if (fig.valid_object ())
+	cmap = Utils::properties<figure> (fig).get_colormap ().matrix_value ();
+    }
+
+  return IconCache::icon (cdata, 16, 16, cmap);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 template <class T>
 ToolBarButton<T>::ToolBarButton (const graphics_object& go, QAction* action)
     : Object (go, action), m_separator (0)
@@ -40,8 +61,7 @@ ToolBarButton<T>::ToolBarButton (const graphics_object& go, QAction* action)
 
   action->setToolTip (Utils::fromStdString (tp.get_tooltipstring ()));
   action->setVisible (tp.is_visible ());
-  QImage img = Utils::makeImageFromCData (tp.get_cdata (), 16, 16);
-  action->setIcon (QIcon (QPixmap::fromImage (img)));
+  action->setIcon (makeIcon (go, tp.get_cdata ()));
   if (tp.is_separator ())
     {
       m_separator = new QAction (action);
@@ -83,11 +103,7 @@ void ToolBarButton<T>::update (int pId)
       action->setToolTip (Utils::fromStdString (tp.get_tooltipstring ()));
       break;
     case T::properties::ID_CDATA:
-	{
-	  QImage img = Utils::makeImageFromCData (tp.get_cdata (), 16, 16);
-
-	  action->setIcon (QIcon (QPixmap::fromImage (img)));
-	}
+      action->setIcon (makeIcon (object (), tp.get_cdata ()));
       break;
     case T::properties::ID_SEPARATOR:
       if (tp.is_separator ())
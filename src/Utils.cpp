@@ -20,8 +20,12 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <QApplication>
+#include <QFontInfo>
+#include <QHash>
 #include <QKeyEvent>
 #include <QMouseEvent>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include <list>
 
@@ -86,32 +90,91 @@ string_vector toStringVector (const QStringList& l)
 
 //////////////////////////////////////////////////////////////////////////////
 
+static QFont::Weight fontWeight (const std::string& weight)
+{
+  if (weight == "light")
+    return QFont::Light;
+  else if (weight == "demi")
+    return QFont::DemiBold;
+  else // "normal", "bold"
+    return QFont::Normal;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static QFont::Style fontStyle (const std::string& angle)
+{
+  if (angle == "italic")
+    return QFont::StyleItalic;
+  else if (angle == "oblique")
+    return QFont::StyleOblique;
+  else // "normal"
+    return QFont::StyleNormal;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct FontKey
+{
+  FontKey (const std::string& name, double size, int weight, int style)
+    : m_name (name), m_size (size), m_weight (weight), m_style (style) { }
+
+  bool operator == (const FontKey& k) const
+    {
+      return (m_size == k.m_size && m_weight == k.m_weight
+	      && m_style == k.m_style && m_name == k.m_name);
+    }
+
+  std::string m_name;
+  double m_size;
+  int m_weight;
+  int m_style;
+};
+
+static uint qHash (const FontKey& k)
+{
+  return (::qHash (QByteArray::fromRawData (k.m_name.data (),
+					    k.m_name.size ()))
+	  ^ ::qHash (static_cast<quint64> (k.m_size * 100))
+	  ^ (k.m_weight << 8) ^ k.m_style);
+}
+
+// Fonts already built by computeFont. The cache is simply flushed when
+// it gets too large, as the number of distinct fonts is usually small.
+static const int s_fontCacheSize = 256;
+static QMutex s_fontCacheMutex;
+static QHash<FontKey, QFont> s_fontCache;
+
+//////////////////////////////////////////////////////////////////////////////
+
 template <class T>
 QFont computeFont (const typename T::properties& props, int height)
 {
-  QFont f (fromStdString (props.get_fontname ()));
+  FontKey key (props.get_fontname (), props.get_fontsize_points (height),
+	       fontWeight (props.get_fontweight ()),
+	       fontStyle (props.get_fontangle ()));
 
-  static std::map<std::string, QFont::Weight> weightMap;
-  static std::map<std::string, QFont::Style> angleMap;
-  static bool mapsInitialized = false;
+  QMutexLocker lock (&s_fontCacheMutex);
 
-  if (! mapsInitialized)
-    {
-      weightMap[std::string ("normal")] = QFont::Normal;
-      weightMap[std::string ("light")] = QFont::Light;
-      weightMap[std::string ("demi")] = QFont::DemiBold;
-      weightMap[std::string ("bold")] = QFont::Normal;
+  QHash<FontKey, QFont>::const_iterator it = s_fontCache.constFind (key);
 
-      angleMap[std::string ("normal")] = QFont::StyleNormal;
-      angleMap[std::string ("italic")] = QFont::StyleItalic;
-      angleMap[std::string ("oblique")] = QFont::StyleOblique;
+  if (it != s_fontCache.constEnd ())
+    return it.value ();
 
-      mapsInitialized = true;
-    }
+  QFont f (fromStdString (key.m_name));
 
-  f.setPointSizeF (props.get_fontsize_points (height));
-  f.setWeight (weightMap[props.get_fontweight ()]);
-  f.setStyle (angleMap[props.get_fontangle ()]);
+  f.setPointSizeF (key.m_size);
+  f.setWeight (key.m_weight);
+  f.setStyle (static_cast<QFont::Style> (key.m_style));
+
+  // Resolve the font now: copies share the resolved data, so widgets
+  // using the cached font don't have to do it again.
+  QFontInfo (f).pixelSize ();
+
+  if (s_fontCache.size () >= s_fontCacheSize)
+    s_fontCache.clear ();
+
+  s_fontCache.insert (key, f);
 
   return f;
 }
@@ -235,79 +298,154 @@ Qt::Alignment fromHVAlign (const caseless_str& halign,
 
 //////////////////////////////////////////////////////////////////////////////
 
-QImage makeImageFromCData (const octave_value& v, int width, int height)
+// Per-value helpers for the CData conversion kernels. NaN values are
+// invalid and make the pixel transparent.
+
+static inline bool isValidValue (const octave_uint8&) { return true; }
+static inline bool isValidValue (float v) { return ! xisnan (v); }
+static inline bool isValidValue (double v) { return ! xisnan (v); }
+
+static inline int toChannel (const octave_uint8& v) { return v.value (); }
+
+static inline int toChannel (double v)
 {
-  dim_vector dv (v.dims ());
+  return (v > 0 ? (v < 1 ? int (v * 255 + 0.5) : 255) : 0);
+}
 
-  if (dv.length () == 3 && dv(2) == 3)
-    {
-      int w = qMin (dv(1), width);
-      int h = qMin (dv(0), height);
+static inline int toChannel (float v) { return toChannel (double (v)); }
 
-      int x_off = (w < width ? (width - w) / 2 : 0);
-      int y_off = (h < height ? (height - h) / 2 : 0);
+static inline int toIndex (const octave_uint8& v, int base, int n)
+{
+  return qBound (0, v.value () - base, n - 1);
+}
 
-      QImage img (width, height, QImage::Format_ARGB32);
-      img.fill (qRgba (0, 0, 0, 0));
+static inline int toIndex (double v, int base, int n)
+{
+  double k = std::floor (v) - base;
 
-      if (v.is_uint8_type ())
-	{
-	  uint8NDArray d = v.uint8_array_value ();
+  return (k > 0 ? (k < n - 1 ? int (k) : n - 1) : 0);
+}
 
-	  for (int i = 0; i < w; i++)
-	    for (int j = 0; j < h; j++)
-	      {
-		int r = d(j, i, 0);
-		int g = d(j, i, 1);
-		int b = d(j, i, 2);
-		int a = 255;
-
-		img.setPixel (x_off + i, y_off + j, qRgba (r, g, b, a));
-	      }
-	}
-      else if (v.is_single_type ())
+static inline int toIndex (float v, int base, int n)
+{
+  return toIndex (double (v), base, n);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Converts the top-left w x h pixels of column-major CData (rows x cols,
+// either with 3 color planes or indexed into table) into img at
+// (x_off, y_off), one scanline at a time. Indices start at base.
+
+template <typename T>
+static void convertCData (QImage& img, const T* data,
+			  octave_idx_type rows, octave_idx_type cols,
+			  int w, int h, int x_off, int y_off,
+			  const QVector<QRgb>& table, int base)
+{
+  octave_idx_type plane = rows * cols;
+  int n = table.size ();
+
+  for (int j = 0; j < h; j++)
+    {
+      QRgb* line = reinterpret_cast<QRgb*> (img.scanLine (y_off + j)) + x_off;
+      const T* r = data + j;
+
+      if (n == 0)
 	{
-	  FloatNDArray f = v.float_array_value ();
+	  const T* g = r + plane;
+	  const T* b = g + plane;
 
 	  for (int i = 0; i < w; i++)
-	    for (int j = 0; j < h; j++)
-	      {
-		float r = f(j, i, 0);
-		float g = f(j, i, 1);
-		float b = f(j, i, 2);
-		int a = (xisnan (r) || xisnan (g) || xisnan (b) ? 0 : 255);
-
-		img.setPixel (x_off + i, y_off + j,
-			      qRgba (xround (r * 255),
-				     xround (g * 255),
-				     xround (b * 255),
-				     a));
-	      }
+	    {
+	      octave_idx_type k = i * rows;
+	      bool valid = (isValidValue (r[k]) && isValidValue (g[k])
+			    && isValidValue (b[k]));
+
+	      line[i] = qRgba (toChannel (r[k]), toChannel (g[k]),
+			       toChannel (b[k]), valid ? 255 : 0);
+	    }
 	}
-      else if (v.is_real_type ())
+      else
 	{
-	  NDArray d = v.array_value ();
+	  const QRgb* lut = table.constData ();
 
 	  for (int i = 0; i < w; i++)
-	    for (int j = 0; j < h; j++)
-	      {
-		double r = d(j, i, 0);
-		double g = d(j, i, 1);
-		double b = d(j, i, 2);
-		int a = (xisnan (r) || xisnan (g) || xisnan (b) ? 0 : 255);
-
-		img.setPixel (x_off + i, y_off + j,
-			      qRgba (xround (r * 255),
-				     xround (g * 255),
-				     xround (b * 255),
-				     a));
-	      }
+	    {
+	      const T& v = r[i * rows];
+
+	      line[i] = (isValidValue (v) ? lut[toIndex (v, base, n)]
+			 : qRgba (0, 0, 0, 0));
+	    }
 	}
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+QImage makeImageFromCData (const octave_value& v, int width, int height,
+			   const Matrix& cmap)
+{
+  // No CData (the default for toolbar buttons) gives a null image.
+  if (v.is_empty ())
+    return QImage ();
+
+  dim_vector dv (v.dims ());
+  bool indexed = (dv.length () == 2);
+
+  if (! (dv.length () == 3 && dv(2) == 3)
+      && ! (indexed && cmap.rows () > 0 && cmap.columns () == 3))
+    return QImage ();
+
+  if (width < 0)
+    width = dv(1);
+  if (height < 0)
+    height = dv(0);
+
+  int w = qMin (dv(1), width);
+  int h = qMin (dv(0), height);
+
+  int x_off = (w < width ? (width - w) / 2 : 0);
+  int y_off = (h < height ? (height - h) / 2 : 0);
+
+  QImage img (width, height, QImage::Format_ARGB32);
+  img.fill (qRgba (0, 0, 0, 0));
+
+  QVector<QRgb> table;
+
+  if (indexed)
+    {
+      table.resize (cmap.rows ());
+      for (int k = 0; k < table.size (); k++)
+	table[k] = qRgb (toChannel (cmap(k, 0)), toChannel (cmap(k, 1)),
+			 toChannel (cmap(k, 2)));
+    }
+
+  // Indices are 1-based for floating point data, and 0-based for integer
+  // data.
+  if (v.is_uint8_type ())
+    {
+      uint8NDArray d = v.uint8_array_value ();
+
+      convertCData (img, d.data (), dv(0), dv(1), w, h, x_off, y_off,
+		    table, 0);
+    }
+  else if (v.is_single_type ())
+    {
+      FloatNDArray f = v.float_array_value ();
+
+      convertCData (img, f.data (), dv(0), dv(1), w, h, x_off, y_off,
+		    table, 1);
+    }
+  else if (v.is_real_type ())
+    {
+      NDArray d = v.array_value ();
 
-      return img;
+      convertCData (img, d.data (), dv(0), dv(1), w, h, x_off, y_off,
+		    table, v.is_integer_type () ? 0 : 1);
     }
 
-  return QImage ();
+  return img;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -76,7 +76,7 @@ namespace Utils
     { return Utils::properties<T> (gh_manager::get_object (h)); }
 
   QImage makeImageFromCData (const octave_value& v, int width = -1,
-			     int height = -1);
+			     int height = -1, const Matrix& cmap = Matrix ());
 
   octave_scalar_map makeKeyEventStruct (QKeyEvent* event);
 };
@@ -31,6 +31,9 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 #include <octave/toplev.h>
 
 #include "Backend.h"
+#include "EventWakeup.h"
+#include "FigureWindow.h"
+#include "IconCache.h"
 #include "Utils.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -53,6 +56,7 @@ bool __init__ (void)
 	  qRegisterMetaType<graphics_object> ("graphics_object");
 
 	  gh_manager::enable_event_processing (true);
+	  EventWakeup::install ();
 
 	  graphics_toolkit tk (new Backend ());
           gtk_manager::load_toolkit (tk);
@@ -82,6 +86,10 @@ bool __init__ (void)
 	  root.set ("defaultuipanelshadowcolor",
 		    octave_value (Utils::toRgb (p.color (QPalette::Dark))));
 
+	  // Start building figure windows ahead of time
+	  QMetaObject::invokeMethod (FigureWindowPool::instance (), "refill",
+				     Qt::QueuedConnection);
+
 	  qtHandlesInitialized = true;
 
 	  return true;
@@ -103,8 +111,14 @@ bool __shutdown__ (void)
 
       gtk_manager::unload_toolkit ("qt");
 
+      EventWakeup::uninstall ();
       gh_manager::enable_event_processing (false);
 
+      QMetaObject::invokeMethod (FigureWindowPool::instance (), "clear",
+				 Qt::QueuedConnection);
+      QMetaObject::invokeMethod (IconCache::instance (), "clear",
+				 Qt::QueuedConnection);
+
       qtHandlesInitialized = false;
 
       return true;
@@ -139,6 +153,101 @@ DEFUN_DLD (__shutdown_qt__, , , "")
 
 //////////////////////////////////////////////////////////////////////////////
 
+static graphics_object figureArgument (const octave_value_list& args,
+				       const char* fcn)
+{
+  graphics_object go;
+
+  if (args.length () == 1)
+    {
+      double h = args(0).double_value ();
+
+      if (! error_state)
+	go = gh_manager::get_object (gh_manager::lookup (h));
+
+      if (! go.valid_object () || ! go.isa ("figure"))
+	{
+	  error ("%s: invalid figure handle", fcn);
+	  go = graphics_object ();
+	}
+    }
+  else
+    print_usage ();
+
+  return go;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+DEFUN_DLD (__begin_update_qt__, args, , "")
+{
+  // Expected arguments:
+  //   args(0) : Figure handle
+  //
+  // Until the matching __end_update_qt__ call, property changes of the
+  // figure and its children are held and applied as one batch, followed
+  // by a single redraw. Calls may be nested.
+  //
+  // If the code between the two calls fails, the figure stays frozen;
+  // use unwind_protect to always close the transaction:
+  //
+  //   __begin_update_qt__ (h);
+  //   unwind_protect
+  //     ...
+  //   unwind_protect_cleanup
+  //     __end_update_qt__ (h);
+  //   end_unwind_protect
+  //
+  // __end_update_qt__ (h, true) closes all nesting levels at once.
+
+  gh_manager::auto_lock lock;
+
+  graphics_object fig = figureArgument (args, "__begin_update_qt__");
+
+  if (fig.valid_object ())
+    QtHandles::Backend::beginTransaction (fig);
+
+  return octave_value ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+DEFUN_DLD (__end_update_qt__, args, , "")
+{
+  // Expected arguments:
+  //   args(0) : Figure handle
+  //   args(1) : (optional) If true, close all nested transactions of the
+  //             figure, e.g. after an error left some of them open
+
+  //
+  // A handle that is no longer a figure is silently ignored: the guarded
+  // code may have closed the figure (its transaction is dropped along with
+  // it), and the unwind_protect cleanup block must not fail because of it.
+
+  gh_manager::auto_lock lock;
+
+  if (args.length () < 1 || args.length () > 2)
+    {
+      print_usage ();
+      return octave_value ();
+    }
+
+  double h = args(0).double_value ();
+  bool force = (args.length () > 1 && args(1).bool_value ());
+
+  if (! error_state)
+    {
+      graphics_object fig = gh_manager::get_object (gh_manager::lookup (h));
+
+      if (fig.valid_object () && fig.isa ("figure"))
+	QtHandles::Backend::endTransaction (fig, force);
+    }
+
+  return octave_value ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 static QStringList makeFilterSpecs (const Cell& filters)
 {
   using namespace QtHandles::Utils;
@@ -17,9 +17,12 @@ SOURCES = \
 	 Container.cpp \
 	 ContextMenu.cpp \
 	 EditControl.cpp \
+	 EventCoalescer.cpp \
+	 EventWakeup.cpp \
 	 Figure.cpp \
 	 FigureWindow.cpp \
 	 GLCanvas.cpp \
+	 IconCache.cpp \
 	 KeyMap.cpp \
 	 ListBoxControl.cpp \
 	 Logger.cpp \
@@ -33,7 +36,9 @@ SOURCES = \
 	 PushButtonControl.cpp \
 	 PushTool.cpp \
 	 RadioButtonControl.cpp \
+	 RenderThread.cpp \
 	 SliderControl.cpp \
+	 StringVectorModel.cpp \
 	 TextControl.cpp \
 	 TextEdit.cpp \
 	 ToggleButtonControl.cpp \
@@ -52,10 +57,13 @@ HEADERS = \
 	 Container.h \
 	 ContextMenu.h \
 	 EditControl.h \
+	 EventCoalescer.h \
+	 EventWakeup.h \
 	 Figure.h \
 	 FigureWindow.h \
 	 GenericEventNotify.h \
 	 GLCanvas.h \
+	 IconCache.h \
 	 KeyMap.h \
 	 ListBoxControl.h \
 	 Logger.h \
@@ -70,7 +78,9 @@ HEADERS = \
 	 PushButtonControl.h \
 	 PushTool.h \
 	 RadioButtonControl.h \
+	 RenderThread.h \
 	 SliderControl.h \
+	 StringVectorModel.h \
 	 TextControl.h \
 	 TextEdit.h \
 	 ToggleButtonControl.h \